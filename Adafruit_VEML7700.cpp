@@ -32,7 +32,10 @@
 /*!
  *    @brief  Instantiates a new VEML7700 class
  */
-Adafruit_VEML7700::Adafruit_VEML7700(void) {}
+Adafruit_VEML7700::Adafruit_VEML7700(void) {
+  veml7700_calibration_default(&calibration);
+  updateResolution();
+}
 
 /*!
  *    @brief  Sets up the hardware for talking to the VEML7700
@@ -78,6 +81,7 @@ bool Adafruit_VEML7700::begin(TwoWire *theWire) {
   enable(true);
 
   lastRead = millis();
+  resetEnergy();
 
   return true;
 }
@@ -89,22 +93,77 @@ bool Adafruit_VEML7700::begin(TwoWire *theWire) {
  */
 float Adafruit_VEML7700::readLux(luxMethod method) {
   bool wait = true;
+  float lux;
   switch (method) {
   case VEML_LUX_NORMAL_NOWAIT:
     wait = false;
     VEML7700_FALLTHROUGH
   case VEML_LUX_NORMAL:
-    return computeLux(readALS(wait));
+    lux = computeLux(readRawALS(wait));
+    break;
   case VEML_LUX_CORRECTED_NOWAIT:
     wait = false;
     VEML7700_FALLTHROUGH
   case VEML_LUX_CORRECTED:
-    return computeLux(readALS(wait), true);
+    lux = computeLux(readRawALS(wait), true);
+    break;
   case VEML_LUX_AUTO:
-    return autoLux();
+    lux = autoLux();
+    break;
   default:
     return -1;
   }
+  closeReading();
+  return lux;
+}
+
+/*!
+ *    @brief Take a reading and capture the raw counts, settings and timestamp
+ * along with the computed lux.
+ *    @param reading Pointer to the structure to fill in
+ *    @param method Lux computation method to use, same as for readLux()
+ *    @returns True on success, false if reading is NULL or method is invalid
+ */
+bool Adafruit_VEML7700::getReading(veml7700_reading_t *reading,
+                                   luxMethod method) {
+  if (!reading)
+    return false;
+
+  bool wait = true;
+  bool corrected = false;
+  uint16_t als;
+  switch (method) {
+  case VEML_LUX_NORMAL_NOWAIT:
+    wait = false;
+    VEML7700_FALLTHROUGH
+  case VEML_LUX_NORMAL:
+    als = readRawALS(wait);
+    break;
+  case VEML_LUX_CORRECTED_NOWAIT:
+    wait = false;
+    VEML7700_FALLTHROUGH
+  case VEML_LUX_CORRECTED:
+    corrected = true;
+    als = readRawALS(wait);
+    break;
+  case VEML_LUX_AUTO:
+    als = autoRange(&corrected);
+    break;
+  default:
+    return false;
+  }
+
+  // both channels are latched from the same integration cycle
+  reading->timestamp = lastRead;
+  reading->als = als;
+  reading->white = readData(White_Data);
+  reading->gain = cachedGain;
+  reading->integrationTime = cachedIntegrationTime;
+  reading->corrected = corrected;
+  reading->lux = computeLux(als, corrected);
+  closeReading();
+
+  return true;
 }
 
 /*!
@@ -115,10 +174,35 @@ float Adafruit_VEML7700::readLux(luxMethod method) {
  *    @returns 16-bit data value from the ALS register
  */
 uint16_t Adafruit_VEML7700::readALS(bool wait) {
+  uint16_t als = readRawALS(wait);
+  closeReading();
+  return als;
+}
+
+/*!
+ *    @brief Read the raw ALS data without closing out a reading, for the
+ * reading paths that read it one or more times per reading
+ *    @param wait True to wait out the integration time first
+ *    @returns 16-bit data value from the ALS register
+ */
+uint16_t Adafruit_VEML7700::readRawALS(bool wait) {
   if (wait)
     readWait();
   lastRead = millis();
-  return ALS_Data->read();
+  return readData(ALS_Data);
+}
+
+/*!
+ *    @brief Close out a reading: everything spent since the previous one,
+ * the sensor running, bus traffic and waiting, is charged to it. Called once
+ * per public reading, however many integrations it took.
+ */
+void Adafruit_VEML7700::closeReading(void) {
+  accountEnergy();
+  uint64_t total = sensorEnergy + busEnergy + waitEnergy;
+  lastReadingEnergy = total - readingStartEnergy;
+  readingStartEnergy = total;
+  readings++;
 }
 
 /*!
@@ -132,7 +216,7 @@ uint16_t Adafruit_VEML7700::readWhite(bool wait) {
   if (wait)
     readWait();
   lastRead = millis();
-  return White_Data->read();
+  return readData(White_Data);
 }
 
 /*!
@@ -140,7 +224,9 @@ uint16_t Adafruit_VEML7700::readWhite(bool wait) {
  *    @param enable The flag to enable/disable
  */
 void Adafruit_VEML7700::enable(bool enable) {
-  ALS_Shutdown->write(!enable);
+  accountEnergy();
+  writeBits(ALS_Shutdown, !enable);
+  cachedEnabled = enable;
   // From app note:
   //   '''
   //   When activating the sensor, set bit 0 of the command register
@@ -149,21 +235,21 @@ void Adafruit_VEML7700::enable(bool enable) {
   //   processor and oscillator.
   //   '''
   if (enable)
-    delay(5); // doubling 2.5ms spec to be sure
+    waitFor(5); // doubling 2.5ms spec to be sure
 }
 
 /*!
  *    @brief Ask if the interrupt is enabled
  *    @returns True if enabled, false otherwise
  */
-bool Adafruit_VEML7700::enabled(void) { return !ALS_Shutdown->read(); }
+bool Adafruit_VEML7700::enabled(void) { return !readBits(ALS_Shutdown); }
 
 /*!
  *    @brief Enable or disable the interrupt
  *    @param enable The flag to enable/disable
  */
 void Adafruit_VEML7700::interruptEnable(bool enable) {
-  ALS_Interrupt_Enable->write(enable);
+  writeBits(ALS_Interrupt_Enable, enable);
 }
 
 /*!
@@ -171,7 +257,7 @@ void Adafruit_VEML7700::interruptEnable(bool enable) {
  *    @returns True if enabled, false otherwise
  */
 bool Adafruit_VEML7700::interruptEnabled(void) {
-  return ALS_Interrupt_Enable->read();
+  return readBits(ALS_Interrupt_Enable);
 }
 
 /*!
@@ -180,7 +266,7 @@ bool Adafruit_VEML7700::interruptEnabled(void) {
  *    VEML7700_PERS_4 or VEML7700_PERS_8
  */
 void Adafruit_VEML7700::setPersistence(uint8_t pers) {
-  ALS_Persistence->write(pers);
+  writeBits(ALS_Persistence, pers);
 }
 
 /*!
@@ -189,7 +275,7 @@ void Adafruit_VEML7700::setPersistence(uint8_t pers) {
  *    VEML7700_PERS_4 or VEML7700_PERS_8
  */
 uint8_t Adafruit_VEML7700::getPersistence(void) {
-  return ALS_Persistence->read();
+  return readBits(ALS_Persistence);
 }
 
 /*!
@@ -202,11 +288,15 @@ uint8_t Adafruit_VEML7700::getPersistence(void) {
  */
 void Adafruit_VEML7700::setIntegrationTime(uint8_t it, bool wait) {
   // save current integration time
-  int flushDelay = wait ? getIntegrationTimeValue() : 0;
+  int flushDelay = wait ? integrationTimeValue(cachedIntegrationTime) : 0;
   // set new integration time
-  ALS_Integration_Time->write(it);
+  accountEnergy();
+  writeBits(ALS_Integration_Time, it);
+  cachedIntegrationTime = it;
+  updateResolution();
   // pause old integration time to insure sensor cycle has completed
-  delay(flushDelay);
+  if (flushDelay > 0)
+    waitFor(flushDelay);
   // reset counter
   lastRead = millis();
 }
@@ -217,7 +307,7 @@ void Adafruit_VEML7700::setIntegrationTime(uint8_t it, bool wait) {
  * VEML7700_IT_400MS, VEML7700_IT_800MS, VEML7700_IT_50MS or VEML7700_IT_25MS
  */
 uint8_t Adafruit_VEML7700::getIntegrationTime(void) {
-  return ALS_Integration_Time->read();
+  return readBits(ALS_Integration_Time);
 }
 
 /*!
@@ -225,22 +315,7 @@ uint8_t Adafruit_VEML7700::getIntegrationTime(void) {
  *    @returns ALS integration time in milliseconds
  */
 int Adafruit_VEML7700::getIntegrationTimeValue(void) {
-  switch (getIntegrationTime()) {
-  case VEML7700_IT_25MS:
-    return 25;
-  case VEML7700_IT_50MS:
-    return 50;
-  case VEML7700_IT_100MS:
-    return 100;
-  case VEML7700_IT_200MS:
-    return 200;
-  case VEML7700_IT_400MS:
-    return 400;
-  case VEML7700_IT_800MS:
-    return 800;
-  default:
-    return -1;
-  }
+  return integrationTimeValue(getIntegrationTime());
 }
 
 /*!
@@ -249,7 +324,9 @@ int Adafruit_VEML7700::getIntegrationTimeValue(void) {
  * VEML7700_GAIN_1_4
  */
 void Adafruit_VEML7700::setGain(uint8_t gain) {
-  ALS_Gain->write(gain);
+  writeBits(ALS_Gain, gain);
+  cachedGain = gain;
+  updateResolution();
   lastRead = millis(); // reset
 }
 
@@ -258,25 +335,14 @@ void Adafruit_VEML7700::setGain(uint8_t gain) {
  *    @returns Gain index, can be VEML7700_GAIN_1, VEML7700_GAIN_2,
  * VEML7700_GAIN_1_8 or VEML7700_GAIN_1_4
  */
-uint8_t Adafruit_VEML7700::getGain(void) { return ALS_Gain->read(); }
+uint8_t Adafruit_VEML7700::getGain(void) { return readBits(ALS_Gain); }
 
 /*!
  *    @brief Get ALS gain value
  *    @returns Actual gain value as float
  */
 float Adafruit_VEML7700::getGainValue(void) {
-  switch (getGain()) {
-  case VEML7700_GAIN_1_8:
-    return 0.125;
-  case VEML7700_GAIN_1_4:
-    return 0.25;
-  case VEML7700_GAIN_1:
-    return 1;
-  case VEML7700_GAIN_2:
-    return 2;
-  default:
-    return -1;
-  }
+  return gainValue(getGain());
 }
 
 /*!
@@ -284,7 +350,9 @@ float Adafruit_VEML7700::getGainValue(void) {
  *    @param enable True if power save should be enabled
  */
 void Adafruit_VEML7700::powerSaveEnable(bool enable) {
-  PowerSave_Enable->write(enable);
+  accountEnergy();
+  writeBits(PowerSave_Enable, enable);
+  cachedPowerSave = enable;
 }
 
 /*!
@@ -292,7 +360,7 @@ void Adafruit_VEML7700::powerSaveEnable(bool enable) {
  *    @returns True if power save is enabled
  */
 bool Adafruit_VEML7700::powerSaveEnabled(void) {
-  return PowerSave_Enable->read();
+  return readBits(PowerSave_Enable);
 }
 
 /*!
@@ -300,7 +368,9 @@ bool Adafruit_VEML7700::powerSaveEnabled(void) {
  *    @param mode The 16-bit data to write to VEML7700_ALS_POWER_SAVE
  */
 void Adafruit_VEML7700::setPowerSaveMode(uint8_t mode) {
-  PowerSave_Mode->write(mode);
+  accountEnergy();
+  writeBits(PowerSave_Mode, mode);
+  cachedPowerSaveMode = mode;
 }
 
 /*!
@@ -308,7 +378,7 @@ void Adafruit_VEML7700::setPowerSaveMode(uint8_t mode) {
  *    @return 16-bit data from VEML7700_ALS_POWER_SAVE
  */
 uint8_t Adafruit_VEML7700::getPowerSaveMode(void) {
-  return PowerSave_Mode->read();
+  return readBits(PowerSave_Mode);
 }
 
 /*!
@@ -316,7 +386,7 @@ uint8_t Adafruit_VEML7700::getPowerSaveMode(void) {
  *    @param value The 16-bit data to write to VEML7700_ALS_THREHOLD_LOW
  */
 void Adafruit_VEML7700::setLowThreshold(uint16_t value) {
-  ALS_LowThreshold->write(value);
+  writeData(ALS_LowThreshold, value);
 }
 
 /*!
@@ -324,7 +394,7 @@ void Adafruit_VEML7700::setLowThreshold(uint16_t value) {
  *    @return 16-bit data from VEML7700_ALS_THREHOLD_LOW
  */
 uint16_t Adafruit_VEML7700::getLowThreshold(void) {
-  return ALS_LowThreshold->read();
+  return readData(ALS_LowThreshold);
 }
 
 /*!
@@ -332,7 +402,7 @@ uint16_t Adafruit_VEML7700::getLowThreshold(void) {
  *    @param value The 16-bit data to write to VEML7700_ALS_THREHOLD_HIGH
  */
 void Adafruit_VEML7700::setHighThreshold(uint16_t value) {
-  ALS_HighThreshold->write(value);
+  writeData(ALS_HighThreshold, value);
 }
 
 /*!
@@ -340,7 +410,7 @@ void Adafruit_VEML7700::setHighThreshold(uint16_t value) {
  *    @return 16-bit data from VEML7700_ALS_THREHOLD_HIGH
  */
 uint16_t Adafruit_VEML7700::getHighThreshold(void) {
-  return ALS_HighThreshold->read();
+  return readData(ALS_HighThreshold);
 }
 
 /*!
@@ -348,16 +418,22 @@ uint16_t Adafruit_VEML7700::getHighThreshold(void) {
  *    @return 16-bit data from VEML7700_INTERRUPTSTATUS
  */
 uint16_t Adafruit_VEML7700::interruptStatus(void) {
-  return Interrupt_Status->read();
+  return readData(Interrupt_Status);
 }
 
 /*!
  *    @brief Determines resolution for current gain and integration time
- * settings.
+ * settings, including the calibration scale.
  */
-float Adafruit_VEML7700::getResolution(void) {
-  return MAX_RES * (IT_MAX / getIntegrationTimeValue()) *
-         (GAIN_MAX / getGainValue());
+float Adafruit_VEML7700::getResolution(void) { return cachedResolution; }
+
+/*!
+ *    @brief Recompute the cached resolution after a change of settings or
+ * calibration, so computeLux() costs the same calibrated or not
+ */
+void Adafruit_VEML7700::updateResolution(void) {
+  cachedResolution =
+      resolution(cachedGain, cachedIntegrationTime) * calibration.scale;
 }
 
 /*!
@@ -367,13 +443,112 @@ float Adafruit_VEML7700::getResolution(void) {
  *    @return lux value
  */
 float Adafruit_VEML7700::computeLux(uint16_t rawALS, bool corrected) {
-  float lux = getResolution() * rawALS;
+  float lux = cachedResolution * rawALS + calibration.offset;
   if (corrected)
-    lux = (((6.0135e-13 * lux - 9.3924e-9) * lux + 8.1488e-5) * lux + 1.0023) *
-          lux;
+    lux = veml7700_calibration_correct(&calibration, lux);
   return lux;
 }
 
+/*!
+ *    @brief Convert a gain setting to its actual gain, without touching the
+ * sensor
+ *    @param gain Gain setting, one of VEML7700_GAIN_*
+ *    @returns Actual gain value as float, or -1 for an invalid setting
+ */
+float Adafruit_VEML7700::gainValue(uint8_t gain) {
+  return veml7700_gain_value(gain);
+}
+
+/*!
+ *    @brief Convert an integration time setting to milliseconds, without
+ * touching the sensor
+ *    @param it Integration time setting, one of VEML7700_IT_*
+ *    @returns Integration time in milliseconds, or -1 for an invalid setting
+ */
+int Adafruit_VEML7700::integrationTimeValue(uint8_t it) {
+  return veml7700_integration_time_value(it);
+}
+
+/*!
+ *    @brief Determines resolution for the given gain and integration time
+ * settings, without touching the sensor
+ *    @param gain Gain setting, one of VEML7700_GAIN_*
+ *    @param it Integration time setting, one of VEML7700_IT_*
+ *    @returns Lux per count
+ */
+float Adafruit_VEML7700::resolution(uint8_t gain, uint8_t it) {
+  return veml7700_resolution(gain, it);
+}
+
+/*!
+ *    @brief Apply the App Note non-linear correction to a linear lux value
+ *    @param lux Linear lux value
+ *    @returns Corrected lux value
+ */
+float Adafruit_VEML7700::correctLux(float lux) {
+  return veml7700_correct_lux(lux);
+}
+
+/*!
+ *    @brief Compute lux from a raw ALS count taken at known settings, without
+ * touching the sensor. Useful for counts that were logged or simulated.
+ *    @param rawALS raw ALS register value
+ *    @param gain Gain setting the count was taken with
+ *    @param it Integration time setting the count was taken with
+ *    @param corrected if true, apply non-linear correction
+ *    @return lux value
+ */
+float Adafruit_VEML7700::rawToLux(uint16_t rawALS, uint8_t gain, uint8_t it,
+                                  bool corrected) {
+  return veml7700_raw_to_lux(rawALS, gain, it, corrected);
+}
+
+/*!
+ *    @brief Compute lux for an array of raw ALS counts all taken at the same
+ * settings, see veml7700_raw_to_lux_array()
+ *    @param rawALS raw ALS register values
+ *    @param lux Output lux values, must not overlap rawALS
+ *    @param count Number of values
+ *    @param gain Gain setting the counts were taken with
+ *    @param it Integration time setting the counts were taken with
+ *    @param corrected if true, apply non-linear correction
+ */
+void Adafruit_VEML7700::rawToLux(const uint16_t *rawALS, float *lux,
+                                 size_t count, uint8_t gain, uint8_t it,
+                                 bool corrected) {
+  veml7700_raw_to_lux_array(rawALS, lux, count, gain, it, corrected);
+}
+
+/*!
+ *    @brief Compute lux for an array of raw ALS counts, each with its own
+ * settings, see veml7700_raw_to_lux_mixed()
+ *    @param rawALS raw ALS register values
+ *    @param gain Gain setting of each count
+ *    @param it Integration time setting of each count
+ *    @param lux Output lux values, must not overlap the inputs
+ *    @param count Number of values
+ *    @param corrected if true, apply non-linear correction
+ */
+void Adafruit_VEML7700::rawToLux(const uint16_t *rawALS, const uint8_t *gain,
+                                 const uint8_t *it, float *lux, size_t count,
+                                 bool corrected) {
+  veml7700_raw_to_lux_mixed(rawALS, gain, it, lux, count, corrected);
+}
+
+/*!
+ *    @brief Integer only version of rawToLux() without the non-linear
+ * correction, for parts without an FPU
+ *    @param rawALS raw ALS register value
+ *    @param gain Gain setting the count was taken with
+ *    @param it Integration time setting the count was taken with
+ *    @return lux value in thousandths of a lux, rounded, or 0 for an invalid
+ * setting
+ */
+uint32_t Adafruit_VEML7700::rawToMilliLux(uint16_t rawALS, uint8_t gain,
+                                          uint8_t it) {
+  return veml7700_raw_to_millilux(rawALS, gain, it);
+}
+
 void Adafruit_VEML7700::readWait(void) {
   // From app note:
   //   '''
@@ -384,11 +559,292 @@ void Adafruit_VEML7700::readWait(void) {
   //   '''
   // Based on testing, it needs more. So doubling to be sure.
 
-  unsigned long timeToWait = 2 * getIntegrationTimeValue(); // see above
+  unsigned long timeToWait =
+      2 * integrationTimeValue(cachedIntegrationTime); // see above
   unsigned long timeWaited = millis() - lastRead;
 
   if (timeWaited < timeToWait)
-    delay(timeToWait - timeWaited);
+    waitFor(timeToWait - timeWaited);
+}
+
+/*!
+ *    @brief Block for a while, keeping track of the time spent
+ *    @param ms Milliseconds to wait
+ */
+void Adafruit_VEML7700::waitFor(unsigned long ms) {
+  if (waitCallback)
+    waitCallback(waitContext, ms);
+  else
+    delay(ms);
+  waitMillis += ms;
+  // uA * mV * ms = pJ, to nJ
+  waitEnergy +=
+      (uint64_t)(energyModel.wait_uA * energyModel.supply_mV * ms / 1000);
+}
+
+/*!
+ *    @brief Read a register, keeping track of bus time spent
+ *    @param reg The register to read
+ *    @returns 16-bit register value
+ */
+uint16_t Adafruit_VEML7700::readData(Adafruit_I2CRegister *reg) {
+  unsigned long start = micros();
+  uint16_t value = reg->read();
+  chargeBus(micros() - start, 1);
+  return value;
+}
+
+/*!
+ *    @brief Write a register, keeping track of bus time spent
+ *    @param reg The register to write
+ *    @param value 16-bit value to write
+ */
+void Adafruit_VEML7700::writeData(Adafruit_I2CRegister *reg, uint16_t value) {
+  unsigned long start = micros();
+  reg->write(value);
+  chargeBus(micros() - start, 1);
+}
+
+/*!
+ *    @brief Read a setting, keeping track of bus time spent
+ *    @param bits The bits of a register to read
+ *    @returns The setting
+ */
+uint32_t Adafruit_VEML7700::readBits(Adafruit_I2CRegisterBits *bits) {
+  unsigned long start = micros();
+  uint32_t value = bits->read();
+  chargeBus(micros() - start, 1);
+  return value;
+}
+
+/*!
+ *    @brief Write a setting, keeping track of bus time spent. The register
+ * is read, modified and written back, so this is two transfers.
+ *    @param bits The bits of a register to write
+ *    @param value The setting
+ */
+void Adafruit_VEML7700::writeBits(Adafruit_I2CRegisterBits *bits,
+                                  uint32_t value) {
+  unsigned long start = micros();
+  bits->write(value);
+  chargeBus(micros() - start, 2);
+}
+
+/*!
+ *    @brief Charge bus transfers to the counters
+ *    @param elapsed Time in us the transfers took
+ *    @param transfers Number of register transfers
+ */
+void Adafruit_VEML7700::chargeBus(unsigned long elapsed, uint8_t transfers) {
+  busTransfers += transfers;
+  busMicros += elapsed;
+  // uA * mV * us = fJ, to nJ
+  busEnergy += (uint64_t)(energyModel.bus_uA * energyModel.supply_mV *
+                          elapsed / 1000000);
+}
+
+/*!
+ *    @brief Charge the sensor's own energy use since the last call to the
+ * counters. Called before every change of power state so each stretch of
+ * time is charged at the current it actually drew.
+ */
+void Adafruit_VEML7700::accountEnergy(void) {
+  unsigned long now = millis();
+  unsigned long elapsed = now - lastEnergyAccount;
+  lastEnergyAccount = now;
+
+  float current = energyModel.shutdown_uA;
+  if (cachedEnabled) {
+    current = energyModel.active_uA;
+    if (cachedPowerSave) {
+      // power save mode sleeps 500ms to 4s between integrations
+      float it = integrationTimeValue(cachedIntegrationTime);
+      float sleep = 500 << cachedPowerSaveMode;
+      current = current * it / (it + sleep);
+      if (current < energyModel.shutdown_uA)
+        current = energyModel.shutdown_uA;
+    }
+  }
+
+  // uA * mV * ms = pJ, to nJ
+  sensorEnergy += (uint64_t)(current * energyModel.supply_mV * elapsed / 1000);
+}
+
+/*!
+ *    @brief Replace the figures used to estimate energy
+ *    @param model The new figures. Only readings taken after this call use
+ * them.
+ */
+void Adafruit_VEML7700::setEnergyModel(const veml7700_energy_model_t *model) {
+  if (!model)
+    return;
+  accountEnergy();
+  energyModel = *model;
+}
+
+/*!
+ *    @brief Estimated energy of the most recent reading from readLux(),
+ * getReading() or readALS(), which covers everything since the reading
+ * before it: the sensor running, bus traffic and any time spent waiting. An
+ * auto-ranged reading is one reading, however many integrations it took.
+ *    @returns Energy in microjoules
+ */
+float Adafruit_VEML7700::getReadingEnergy(void) {
+  return lastReadingEnergy / 1000.0;
+}
+
+/*!
+ *    @brief Estimated energy used since begin() or resetEnergy()
+ *    @returns Energy in microjoules
+ */
+float Adafruit_VEML7700::getEnergy(void) {
+  accountEnergy();
+  return (sensorEnergy + busEnergy + waitEnergy) / 1000.0;
+}
+
+/*!
+ *    @brief Get the cumulative energy and activity counters
+ *    @param stats Pointer to the structure to fill in
+ */
+void Adafruit_VEML7700::getEnergyStats(veml7700_energy_stats_t *stats) {
+  if (!stats)
+    return;
+  accountEnergy();
+  stats->readings = readings;
+  stats->busTransfers = busTransfers;
+  stats->busMicros = busMicros;
+  stats->waitMillis = waitMillis;
+  stats->sensor_uJ = sensorEnergy / 1000.0;
+  stats->bus_uJ = busEnergy / 1000.0;
+  stats->wait_uJ = waitEnergy / 1000.0;
+}
+
+/*!
+ *    @brief Zero the energy and activity counters
+ */
+void Adafruit_VEML7700::resetEnergy(void) {
+  lastEnergyAccount = millis();
+  sensorEnergy = busEnergy = waitEnergy = 0;
+  readingStartEnergy = lastReadingEnergy = 0;
+  readings = busTransfers = busMicros = waitMillis = 0;
+}
+
+/*!
+ *    @brief Set this unit's calibration, used by readLux() and getReading().
+ * The scale is folded into the cached resolution, so calibrated readings
+ * cost no more than uncalibrated ones.
+ *    @param calibration The calibration, or NULL for a nominal part
+ */
+void Adafruit_VEML7700::setCalibration(
+    const veml7700_calibration_t *calibration) {
+  if (calibration)
+    this->calibration = *calibration;
+  else
+    veml7700_calibration_default(&this->calibration);
+  updateResolution();
+}
+
+/*!
+ *    @brief Get this unit's calibration
+ *    @param calibration Pointer to the structure to fill in
+ */
+void Adafruit_VEML7700::getCalibration(veml7700_calibration_t *calibration) {
+  if (calibration)
+    *calibration = this->calibration;
+}
+
+/*!
+ *    @brief Set this unit's calibration from a blob, such as one kept in
+ * EEPROM, see Adafruit_VEML7700_Calibration.h
+ *    @param blob The blob
+ *    @param length Bytes in the blob
+ *    @returns True on success, false if the blob is invalid and the
+ * calibration was left unchanged
+ */
+bool Adafruit_VEML7700::loadCalibration(const uint8_t *blob, size_t length) {
+  veml7700_calibration_t loaded;
+  if (!blob || !veml7700_calibration_decode(blob, length, &loaded))
+    return false;
+  setCalibration(&loaded);
+  return true;
+}
+
+/*!
+ *    @brief Replace delay() for every wait in the driver: the start up wait in
+ * enable(), the flush in setIntegrationTime() and the integration wait in
+ * readALS(), readWhite() and readLux(). Use this to sleep the MCU or service
+ * other work while the sensor integrates.
+ *    @param wait The callback to use, or NULL to go back to delay()
+ *    @param context Passed through to every call of wait
+ */
+void Adafruit_VEML7700::setWaitCallback(veml7700_wait_t wait, void *context) {
+  waitCallback = wait;
+  waitContext = context;
+}
+
+/*!
+ *    @brief Replace the auto-range policy used by VEML_LUX_AUTO
+ *    @param policy The policy to use, or NULL to restore the default
+ * autoRangeAppNote()
+ */
+void Adafruit_VEML7700::setAutoRange(veml7700_autorange_t policy) {
+  autoRangePolicy = policy ? policy : autoRangeAppNote;
+}
+
+/*!
+ *  @brief Automatically adjust gain and integration time using the current
+ * auto-range policy, then compute lux from the resulting count.
+ */
+float Adafruit_VEML7700::autoLux(void) {
+  bool useCorrection = false;
+  uint16_t ALS = autoRange(&useCorrection);
+  return computeLux(ALS, useCorrection);
+}
+
+/** Settings last written while auto-ranging, 0xFF if not yet written */
+typedef struct {
+  Adafruit_VEML7700 *sensor; ///< Sensor being ranged
+  uint8_t gain;              ///< Last gain written
+  uint8_t it;                ///< Last integration time written
+} veml7700_autorange_context_t;
+
+/*!
+ *  @brief Run the auto-range policy against the sensor
+ *  @param useCorrection Set to true if the non-linear correction should be
+ * applied to the returned count
+ *  @return Raw ALS count at the final gain and integration time
+ */
+uint16_t Adafruit_VEML7700::autoRange(bool *useCorrection) {
+  veml7700_autorange_context_t context = {this, 0xFF, 0xFF};
+  uint8_t gain = cachedGain;
+  uint8_t it = cachedIntegrationTime;
+
+  *useCorrection = false;
+  return autoRangePolicy(autoRangeIntegrate, &context, &gain, &it,
+                         useCorrection);
+}
+
+/*!
+ *  @brief Integrate callback used by autoRange(). Only writes the settings
+ * that changed since the previous measurement.
+ *  @param context Pointer to a veml7700_autorange_context_t
+ *  @param gain Gain setting to measure with
+ *  @param it Integration time setting to measure with
+ *  @return Raw ALS count
+ */
+uint16_t Adafruit_VEML7700::autoRangeIntegrate(void *context, uint8_t gain,
+                                               uint8_t it) {
+  veml7700_autorange_context_t *ctx = (veml7700_autorange_context_t *)context;
+
+  if (gain != ctx->gain) {
+    ctx->sensor->setGain(gain);
+    ctx->gain = gain;
+  }
+  if (it != ctx->it) {
+    ctx->sensor->setIntegrationTime(it);
+    ctx->it = it;
+  }
+  return ctx->sensor->readRawALS(true);
 }
 
 /*!
@@ -396,22 +852,29 @@ void Adafruit_VEML7700::readWait(void) {
  * Application", Vishay Document Number: 84323, Fig. 24 Flow Chart. This will
  * automatically adjust gain and integration time as needed to obtain a good raw
  * count value. Additionally, a non-linear correction is applied if needed.
+ * This is the default auto-range policy.
+ *  @param integrate Callback that takes one measurement
+ *  @param context Passed through to integrate
+ *  @param gain Set to the gain of the returned count
+ *  @param it Set to the integration time of the returned count
+ *  @param useCorrection Set to true if the non-linear correction applies
+ *  @return Raw ALS count
  */
-float Adafruit_VEML7700::autoLux(void) {
+uint16_t Adafruit_VEML7700::autoRangeAppNote(veml7700_integrate_t integrate,
+                                             void *context, uint8_t *gain,
+                                             uint8_t *it,
+                                             bool *useCorrection) {
   const uint8_t gains[] = {VEML7700_GAIN_1_8, VEML7700_GAIN_1_4,
                            VEML7700_GAIN_1, VEML7700_GAIN_2};
   const uint8_t intTimes[] = {VEML7700_IT_25MS,  VEML7700_IT_50MS,
                               VEML7700_IT_100MS, VEML7700_IT_200MS,
                               VEML7700_IT_400MS, VEML7700_IT_800MS};
 
-  uint8_t gainIndex = 0;      // start with ALS gain = 1/8
-  uint8_t itIndex = 2;        // start with ALS integration time = 100ms
-  bool useCorrection = false; // flag for non-linear correction
-
-  setGain(gains[gainIndex]);
-  setIntegrationTime(intTimes[itIndex]);
+  uint8_t gainIndex = 0;  // start with ALS gain = 1/8
+  uint8_t itIndex = 2;    // start with ALS integration time = 100ms
+  *useCorrection = false; // flag for non-linear correction
 
-  uint16_t ALS = readALS(true);
+  uint16_t ALS = integrate(context, gains[gainIndex], intTimes[itIndex]);
   // Serial.println("** AUTO LUX DEBUG **");
   // Serial.print("ALS initial = "); Serial.println(ALS);
 
@@ -421,11 +884,11 @@ float Adafruit_VEML7700::autoLux(void) {
     // compute lux using simple linear formula
     while ((ALS <= 100) && !((gainIndex == 3) && (itIndex == 5))) {
       if (gainIndex < 3) {
-        setGain(gains[++gainIndex]);
+        gainIndex++;
       } else if (itIndex < 5) {
-        setIntegrationTime(intTimes[++itIndex]);
+        itIndex++;
       }
-      ALS = readALS(true);
+      ALS = integrate(context, gains[gainIndex], intTimes[itIndex]);
       // Serial.print("ALS low lux = "); Serial.println(ALS);
     }
 
@@ -433,14 +896,16 @@ float Adafruit_VEML7700::autoLux(void) {
 
     // decrease integration time as needed
     // compute lux using non-linear correction
-    useCorrection = true;
+    *useCorrection = true;
     while ((ALS > 10000) && (itIndex > 0)) {
-      setIntegrationTime(intTimes[--itIndex]);
-      ALS = readALS(true);
+      itIndex--;
+      ALS = integrate(context, gains[gainIndex], intTimes[itIndex]);
       // Serial.print("ALS  hi lux = "); Serial.println(ALS);
     }
   }
   // Serial.println("** AUTO LUX DEBUG **");
 
-  return computeLux(ALS, useCorrection);
-}
\ No newline at end of file
+  *gain = gains[gainIndex];
+  *it = intTimes[itIndex];
+  return ALS;
+}
@@ -22,6 +22,9 @@
 #include <Adafruit_I2CRegister.h>
 #include <Wire.h>
 
+#include "Adafruit_VEML7700_Calibration.h"
+#include "Adafruit_VEML7700_Lux.h"
+
 #define VEML7700_I2CADDR_DEFAULT 0x10 ///< I2C address
 
 #define VEML7700_ALS_CONFIG 0x00        ///< Light configuration register
@@ -35,18 +38,6 @@
 #define VEML7700_INTERRUPT_HIGH 0x4000 ///< Interrupt status for high threshold
 #define VEML7700_INTERRUPT_LOW 0x8000  ///< Interrupt status for low threshold
 
-#define VEML7700_GAIN_1 0x00   ///< ALS gain 1x
-#define VEML7700_GAIN_2 0x01   ///< ALS gain 2x
-#define VEML7700_GAIN_1_8 0x02 ///< ALS gain 1/8x
-#define VEML7700_GAIN_1_4 0x03 ///< ALS gain 1/4x
-
-#define VEML7700_IT_100MS 0x00 ///< ALS intetgration time 100ms
-#define VEML7700_IT_200MS 0x01 ///< ALS intetgration time 200ms
-#define VEML7700_IT_400MS 0x02 ///< ALS intetgration time 400ms
-#define VEML7700_IT_800MS 0x03 ///< ALS intetgration time 800ms
-#define VEML7700_IT_50MS 0x08  ///< ALS intetgration time 50ms
-#define VEML7700_IT_25MS 0x0C  ///< ALS intetgration time 25ms
-
 #define VEML7700_PERS_1 0x00 ///< ALS irq persistence 1 sample
 #define VEML7700_PERS_2 0x01 ///< ALS irq persistence 2 samples
 #define VEML7700_PERS_4 0x02 ///< ALS irq persistence 4 samples
@@ -67,14 +58,62 @@
 #define VEML7700_FALLTHROUGH
 #endif
 
-/** Options for lux reading method */
-typedef enum {
-  VEML_LUX_NORMAL,
-  VEML_LUX_CORRECTED,
-  VEML_LUX_AUTO,
-  VEML_LUX_NORMAL_NOWAIT,
-  VEML_LUX_CORRECTED_NOWAIT
-} luxMethod;
+/*!
+ *  @brief Figures used to estimate energy. Defaults are typical datasheet
+ *         values for a 3.3V breakout with 10K pull-ups.
+ */
+typedef struct {
+  uint16_t supply_mV; ///< Supply voltage in mV, default 3300
+  float active_uA;    ///< Sensor current while measuring, default 45
+  float shutdown_uA;  ///< Sensor current while shut down, default 0.5
+  float bus_uA;       ///< Pull-up current while the bus is busy, default 330
+  float wait_uA; ///< MCU current while blocked in a wait, default 0 (ignored)
+} veml7700_energy_model_t;
+
+/** Cumulative energy and activity since begin() or resetEnergy() */
+typedef struct {
+  uint32_t readings;     ///< Readings taken, auto-ranged ones count once
+  uint32_t busTransfers; ///< Register reads and writes, settings included
+  uint32_t busMicros;    ///< Time spent on register reads and writes
+  uint32_t waitMillis;   ///< Time spent blocked waiting on the sensor
+  float sensor_uJ;       ///< Energy used by the sensor itself
+  float bus_uJ;          ///< Energy used by bus activity
+  float wait_uJ;         ///< Energy used by the MCU while waiting
+} veml7700_energy_stats_t;
+
+/*!
+ *  @brief Callback used for every blocking wait in the driver
+ *  @param context Opaque pointer given to setWaitCallback()
+ *  @param ms Milliseconds to wait. The callback may sleep, run other work or
+ *         advance a virtual clock, but must not return before this much time
+ *         has passed.
+ */
+typedef void (*veml7700_wait_t)(void *context, unsigned long ms);
+
+/*!
+ *  @brief Callback used by auto-range policies to take one measurement
+ *  @param context Opaque pointer handed to the policy by its caller
+ *  @param gain Gain setting to measure with, one of VEML7700_GAIN_*
+ *  @param it Integration time setting to measure with, one of VEML7700_IT_*
+ *  @returns Raw ALS count
+ */
+typedef uint16_t (*veml7700_integrate_t)(void *context, uint8_t gain,
+                                         uint8_t it);
+
+/*!
+ *  @brief Auto-range policy used by VEML_LUX_AUTO. Measures through the
+ *         integrate callback until it has a good count.
+ *  @param integrate Callback that takes one measurement
+ *  @param context Passed through to integrate
+ *  @param gain In: current gain setting. Out: gain of the returned count
+ *  @param it In: current integration time setting. Out: integration time of
+ *         the returned count
+ *  @param useCorrection Set to true if the non-linear correction applies
+ *  @returns Raw ALS count
+ */
+typedef uint16_t (*veml7700_autorange_t)(veml7700_integrate_t integrate,
+                                         void *context, uint8_t *gain,
+                                         uint8_t *it, bool *useCorrection);
 
 /*!
  *    @brief  Class that stores state and functions for interacting with
@@ -112,16 +151,74 @@ public:
   uint16_t readALS(bool wait = false);
   uint16_t readWhite(bool wait = false);
   float readLux(luxMethod method = VEML_LUX_NORMAL);
+  bool getReading(veml7700_reading_t *reading,
+                  luxMethod method = VEML_LUX_NORMAL);
+  void setAutoRange(veml7700_autorange_t policy);
+  void setWaitCallback(veml7700_wait_t wait, void *context = NULL);
+
+  void setEnergyModel(const veml7700_energy_model_t *model);
+  float getReadingEnergy(void);
+  float getEnergy(void);
+  void getEnergyStats(veml7700_energy_stats_t *stats);
+  void resetEnergy(void);
+
+  void setCalibration(const veml7700_calibration_t *calibration);
+  void getCalibration(veml7700_calibration_t *calibration);
+  bool loadCalibration(const uint8_t *blob, size_t length);
+
+  static float gainValue(uint8_t gain);
+  static int integrationTimeValue(uint8_t it);
+  static float resolution(uint8_t gain, uint8_t it);
+  static float correctLux(float lux);
+  static float rawToLux(uint16_t rawALS, uint8_t gain, uint8_t it,
+                        bool corrected = false);
+  static void rawToLux(const uint16_t *rawALS, float *lux, size_t count,
+                       uint8_t gain, uint8_t it, bool corrected = false);
+  static void rawToLux(const uint16_t *rawALS, const uint8_t *gain,
+                       const uint8_t *it, float *lux, size_t count,
+                       bool corrected = false);
+  static uint32_t rawToMilliLux(uint16_t rawALS, uint8_t gain, uint8_t it);
+  static uint16_t autoRangeAppNote(veml7700_integrate_t integrate,
+                                   void *context, uint8_t *gain, uint8_t *it,
+                                   bool *useCorrection);
 
 private:
-  const float MAX_RES = 0.0036;
-  const float GAIN_MAX = 2;
-  const float IT_MAX = 800;
   float getResolution(void);
+  void updateResolution(void);
   float computeLux(uint16_t rawALS, bool corrected = false);
   float autoLux(void);
+  uint16_t autoRange(bool *useCorrection);
+  static uint16_t autoRangeIntegrate(void *context, uint8_t gain, uint8_t it);
   void readWait(void);
+  void waitFor(unsigned long ms);
+  uint16_t readRawALS(bool wait);
+  void closeReading(void);
+  uint16_t readData(Adafruit_I2CRegister *reg);
+  void writeData(Adafruit_I2CRegister *reg, uint16_t value);
+  uint32_t readBits(Adafruit_I2CRegisterBits *bits);
+  void writeBits(Adafruit_I2CRegisterBits *bits, uint32_t value);
+  void chargeBus(unsigned long elapsed, uint8_t transfers);
+  void accountEnergy(void);
   unsigned long lastRead;
+  veml7700_wait_t waitCallback = NULL;
+  void *waitContext = NULL;
+
+  // settings as last written, so the hot paths don't read them back
+  uint8_t cachedGain = VEML7700_GAIN_1;
+  uint8_t cachedIntegrationTime = VEML7700_IT_100MS;
+  bool cachedEnabled = false;
+  bool cachedPowerSave = false;
+  uint8_t cachedPowerSaveMode = VEML7700_POWERSAVE_MODE1;
+  // lux per count at the cached settings, calibration scale included
+  float cachedResolution;
+  veml7700_calibration_t calibration;
+
+  veml7700_energy_model_t energyModel = {3300, 45, 0.5, 330, 0};
+  unsigned long lastEnergyAccount = 0;
+  uint64_t sensorEnergy = 0, busEnergy = 0, waitEnergy = 0; // nJ
+  uint64_t readingStartEnergy = 0, lastReadingEnergy = 0;   // nJ
+  uint32_t readings = 0, busTransfers = 0, busMicros = 0, waitMillis = 0;
+  veml7700_autorange_t autoRangePolicy = autoRangeAppNote;
 
   Adafruit_I2CRegister *ALS_Config, *ALS_Data, *White_Data, *ALS_HighThreshold,
       *ALS_LowThreshold, *Power_Saving, *Interrupt_Status;
@@ -0,0 +1,116 @@
+/*!
+ *  @file Adafruit_VEML7700_Accumulator.cpp
+ *
+ * 	Oversampling of alternate VEML7700 integrations for finer low light
+ * 	resolution
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Accumulator.h"
+
+/*!
+ *    @brief  Instantiates an accumulator for a sensor that has been
+ * begin()'d
+ *    @param  sensor The sensor to read
+ *    @param  count Integrations to sum per result, 1 to 65535
+ */
+Adafruit_VEML7700_Accumulator::Adafruit_VEML7700_Accumulator(
+    Adafruit_VEML7700 *sensor, uint16_t count)
+    : _sensor(sensor), _gain(VEML7700_GAIN_2), _it(VEML7700_IT_800MS) {
+  setCount(count);
+}
+
+/*!
+ *    @brief  Set the number of integrations summed per result. Resolution
+ * improves with the count and noise with its square root, while each result
+ * takes twice the count in integration times. Starts a new accumulation.
+ *    @param  count Integrations per result, 1 to 65535, so the sum of counts
+ * fits in 32 bits
+ */
+void Adafruit_VEML7700_Accumulator::setCount(uint16_t count) {
+  _count = count ? count : 1;
+  reset();
+}
+
+/*!
+ *    @brief  Drop the current accumulation. The next count is read after a
+ * full integration from now, so it cannot predate a settings change.
+ */
+void Adafruit_VEML7700_Accumulator::reset(void) {
+  _n = 0;
+  _sum = 0;
+  _squares = 0;
+  _saturated = false;
+  _lastSample = millis();
+}
+
+/*!
+ *    @brief  Call this often, from loop(). Reads a count every two
+ * integration times, so every other integration is summed, and completes a
+ * result every count reads. A change of gain or integration time starts a
+ * new accumulation, as does the first call if the sensor is not at gain 2
+ * and 800ms.
+ *    @param  result Optional pointer to receive the completed result
+ *    @returns True if a result was completed
+ */
+bool Adafruit_VEML7700_Accumulator::update(veml7700_accumulation_t *result) {
+  if (!_sensor)
+    return false;
+
+  // the driver waits twice the integration time before reading, see
+  // readWait(), so reading no faster never sees the same result twice
+  unsigned long now = millis();
+  unsigned long period = 2 * veml7700_integration_time_value(_it);
+  if (now - _lastSample < period)
+    return false;
+
+  veml7700_reading_t reading;
+  if (!_sensor->getReading(&reading, VEML_LUX_NORMAL_NOWAIT))
+    return false;
+  if ((reading.gain != _gain) || (reading.integrationTime != _it)) {
+    // the count may straddle the change, so start over a period later
+    _gain = reading.gain;
+    _it = reading.integrationTime;
+    reset();
+    return false;
+  }
+  _lastSample = now;
+
+  _sum += reading.als;
+  _squares += (uint32_t)reading.als * reading.als;
+  _saturated = _saturated || (reading.als == 0xFFFF);
+  if (++_n < _count)
+    return false;
+
+  if (result) {
+    // the sensor's calibration, as its own readings use it
+    veml7700_calibration_t calibration;
+    _sensor->getCalibration(&calibration);
+    float resolution = veml7700_resolution(_gain, _it) * calibration.scale;
+    float mean = (float)_sum / _n;
+    // sample variance of the counts from exact integer sums
+    float variance = 0;
+    if (_n > 1) {
+      uint64_t spread = _squares * _n - (uint64_t)_sum * _sum;
+      variance = (float)spread / ((float)_n * (_n - 1));
+    }
+    // each count is also off by up to half a count, uniformly
+    float error = sqrt((variance + 1.0 / 12) / _n);
+
+    result->timestamp = reading.timestamp;
+    result->sum = _sum;
+    result->count = _n;
+    result->gain = _gain;
+    result->integrationTime = _it;
+    result->saturated = _saturated;
+    result->lux = mean * resolution + calibration.offset;
+    result->uncertainty = error * resolution;
+  }
+
+  _n = 0;
+  _sum = 0;
+  _squares = 0;
+  _saturated = false;
+  return true;
+}
@@ -0,0 +1,72 @@
+/*!
+ *  @file Adafruit_VEML7700_Accumulator.h
+ *
+ * 	Oversampling of alternate VEML7700 integrations for finer low light
+ * 	resolution
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_ACCUMULATOR_H
+#define _ADAFRUIT_VEML7700_ACCUMULATOR_H
+
+#include "Adafruit_VEML7700.h"
+
+/** Result of one accumulation */
+typedef struct {
+  uint32_t timestamp;      ///< millis() at which the last count was read
+  uint32_t sum;            ///< Sum of the ALS counts
+  uint16_t count;          ///< Number of integrations summed
+  uint8_t gain;            ///< Gain setting, one of VEML7700_GAIN_*
+  uint8_t integrationTime; ///< Integration time setting, one of VEML7700_IT_*
+  bool saturated;          ///< True if any count was at full scale
+  float lux;               ///< Mean lux, with the sensor's calibration
+  float uncertainty;       ///< Standard error of lux, noise and quantization
+} veml7700_accumulation_t;
+
+/*!
+ *    @brief  Sums the ALS counts of every other integration, so the mean
+ *            resolves light below one count of the sensor's finest setting.
+ *            The sensor has no data ready flag, so like readWait() counts
+ *            are read two integration times apart, which can never see the
+ *            same integration twice: a result of N counts takes 2 x N
+ *            integration times, 25.6 s for the default 16 at 800ms, and
+ *            averages light over only half of that time. update() never
+ *            blocks, it returns at once until the next count is due. The
+ *            sum of counts and of their squares are kept in integers, for an
+ *            exact mean and a standard error from the spread of the counts.
+ */
+class Adafruit_VEML7700_Accumulator {
+public:
+  Adafruit_VEML7700_Accumulator(Adafruit_VEML7700 *sensor,
+                                uint16_t count = 16);
+
+  void setCount(uint16_t count);
+  void reset(void);
+
+  bool update(veml7700_accumulation_t *result = NULL);
+
+  /*! @returns Integrations summed so far in the current accumulation */
+  uint16_t pending(void) const { return _n; }
+  /*! @returns Integrations summed per result */
+  uint16_t count(void) const { return _count; }
+
+private:
+  Adafruit_VEML7700 *_sensor;
+  uint16_t _count, _n;
+  uint32_t _sum;
+  uint64_t _squares;
+  uint8_t _gain, _it;
+  bool _saturated;
+  unsigned long _lastSample;
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*!
+ *  @file Adafruit_VEML7700_Bridge.cpp
+ *
+ * 	Command protocol for driving a VEML7700 from a host over a serial link
+ *
+ * 	Free of Arduino dependencies, so the host side and a simulated device
+ * 	build it unchanged.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Bridge.h"
+
+/*!
+ *    @brief  Parse an acknowledgement payload
+ *    @param  payload The payload
+ *    @param  length Bytes in the payload
+ *    @param  tag Set to the batch's tag
+ *    @param  status Set to the batch's veml7700_bridge_status_t
+ *    @param  executed Set to the number of commands that ran
+ *    @returns True if the payload is an acknowledgement
+ */
+bool veml7700_bridge_parse_ack(const uint8_t *payload, size_t length,
+                               uint8_t *tag, uint8_t *status,
+                               uint8_t *executed) {
+  if ((length != VEML7700_BRIDGE_ACK_SIZE) ||
+      (payload[0] != VEML7700_BRIDGE_ACK))
+    return false;
+  *tag = payload[1];
+  *status = payload[2];
+  *executed = payload[3];
+  return true;
+}
+
+/*!
+ *    @brief  Instantiates a bridge
+ *    @param  configure Called to change the sensor's settings
+ *    @param  measure Called to take a reading
+ *    @param  send Called with each reply payload
+ *    @param  context Passed to the callbacks
+ */
+Adafruit_VEML7700_Bridge::Adafruit_VEML7700_Bridge(
+    veml7700_bridge_configure_t configure, veml7700_bridge_measure_t measure,
+    veml7700_bridge_send_t send, void *context)
+    : _configure(configure), _measure(measure), _send(send),
+      _context(context), _sequence(0), _remaining(0), _bursting(false) {}
+
+/*!
+ *    @brief  Feed a byte received from the host. A byte that completes a
+ * batch runs it before returning.
+ *    @param  byte The byte
+ */
+void Adafruit_VEML7700_Bridge::push(uint8_t byte) {
+  size_t length = _decoder.push(byte);
+  if (length)
+    execute(_decoder.payload(), length);
+}
+
+/*!
+ *    @brief  Take the next burst reading, if a burst is streaming. Call
+ * this from the main loop along with push().
+ *    @returns True if a reading was taken
+ */
+bool Adafruit_VEML7700_Bridge::poll(void) {
+  if (!_bursting)
+    return false;
+  if (!reading()) {
+    _bursting = false;
+    return false;
+  }
+  if (_remaining && !--_remaining)
+    _bursting = false;
+  return true;
+}
+
+/*!
+ *    @brief  Run a batch and acknowledge it
+ *    @param  payload The packet payload
+ *    @param  length Bytes in the payload
+ */
+void Adafruit_VEML7700_Bridge::execute(const uint8_t *payload,
+                                       size_t length) {
+  // other packet types are not for the bridge
+  if ((length < 2) || (payload[0] != VEML7700_BRIDGE_BATCH))
+    return;
+
+  uint8_t status = VEML7700_BRIDGE_OK;
+  uint8_t executed = 0;
+  size_t i = 2;
+  while ((i < length) && (status == VEML7700_BRIDGE_OK)) {
+    uint8_t opcode = payload[i++];
+    switch (opcode) {
+    case VEML7700_BRIDGE_CONFIGURE:
+      if (i + 2 > length) {
+        status = VEML7700_BRIDGE_BAD_COMMAND;
+      } else if ((veml7700_gain_value(payload[i]) < 0) ||
+                 (veml7700_integration_time_value(payload[i + 1]) < 0)) {
+        status = VEML7700_BRIDGE_BAD_ARGUMENT;
+      } else if (!_configure(_context, payload[i], payload[i + 1])) {
+        status = VEML7700_BRIDGE_DEVICE_ERROR;
+      }
+      i += 2;
+      break;
+    case VEML7700_BRIDGE_SNAPSHOT:
+      if (!reading())
+        status = VEML7700_BRIDGE_DEVICE_ERROR;
+      break;
+    case VEML7700_BRIDGE_BURST:
+      if (i + 2 > length) {
+        status = VEML7700_BRIDGE_BAD_COMMAND;
+      } else {
+        _remaining = payload[i] | ((uint16_t)payload[i + 1] << 8);
+        _bursting = true;
+      }
+      i += 2;
+      break;
+    case VEML7700_BRIDGE_STOP:
+      _bursting = false;
+      _remaining = 0;
+      break;
+    default:
+      status = VEML7700_BRIDGE_BAD_COMMAND;
+      break;
+    }
+    if (status == VEML7700_BRIDGE_OK)
+      executed++;
+  }
+
+  uint8_t ack[VEML7700_BRIDGE_ACK_SIZE] = {VEML7700_BRIDGE_ACK, payload[1],
+                                           status, executed};
+  _send(_context, ack, sizeof(ack));
+}
+
+/*!
+ *    @brief  Take a reading and send it
+ *    @returns True on success
+ */
+bool Adafruit_VEML7700_Bridge::reading(void) {
+  veml7700_log_record_t record;
+  uint8_t payload[VEML7700_STREAM_READING_SIZE];
+
+  if (!_measure(_context, &record))
+    return false;
+  uint8_t length = veml7700_stream_reading(&record, _sequence++, payload);
+  _send(_context, payload, length);
+  return true;
+}
@@ -0,0 +1,120 @@
+/*!
+ *  @file Adafruit_VEML7700_Bridge.h
+ *
+ * 	Command protocol for driving a VEML7700 from a host over a serial link
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_BRIDGE_H
+#define _ADAFRUIT_VEML7700_BRIDGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Adafruit_VEML7700_Stream.h"
+
+/*
+ * Commands and replies travel as stream packets, see
+ * Adafruit_VEML7700_Stream.h. The host sends a batch of commands in one
+ * packet so a whole sequence costs one round trip:
+ *
+ *   type      VEML7700_BRIDGE_BATCH
+ *   tag       any byte, echoed in the acknowledgement
+ *   commands  each an opcode then its arguments
+ *
+ *     VEML7700_BRIDGE_CONFIGURE gain it    settings, VEML7700_GAIN_* and
+ *                                          VEML7700_IT_*
+ *     VEML7700_BRIDGE_SNAPSHOT             take one reading now
+ *     VEML7700_BRIDGE_BURST count0 count1  start streaming count readings,
+ *                                          little endian, 0 for no limit
+ *     VEML7700_BRIDGE_STOP                 end a burst
+ *
+ * The commands run in order until one fails. Snapshot readings go out as
+ * they are taken, then the acknowledgement:
+ *
+ *   type      VEML7700_BRIDGE_ACK
+ *   tag       the batch's tag
+ *   status    VEML7700_BRIDGE_OK or the error of the failed command
+ *   executed  number of commands that ran
+ *
+ * Burst readings follow from poll(), one per measurement, so the host
+ * learns of a bad batch before any of them. Readings are stream reading
+ * packets with one sequence shared by snapshots and bursts.
+ */
+
+#define VEML7700_BRIDGE_BATCH 0x10     ///< Packet type of a command batch
+#define VEML7700_BRIDGE_ACK 0x11       ///< Packet type of an acknowledgement
+#define VEML7700_BRIDGE_ACK_SIZE 4     ///< Bytes in an acknowledgement
+#define VEML7700_BRIDGE_CONFIGURE 0x01 ///< Set gain and integration time
+#define VEML7700_BRIDGE_SNAPSHOT 0x02  ///< Take one reading
+#define VEML7700_BRIDGE_BURST 0x03     ///< Stream a number of readings
+#define VEML7700_BRIDGE_STOP 0x04      ///< End a burst
+
+/** Acknowledgement status */
+typedef enum {
+  VEML7700_BRIDGE_OK,           ///< Every command ran
+  VEML7700_BRIDGE_BAD_COMMAND,  ///< Unknown opcode or truncated arguments
+  VEML7700_BRIDGE_BAD_ARGUMENT, ///< Invalid setting
+  VEML7700_BRIDGE_DEVICE_ERROR, ///< The sensor failed to respond
+} veml7700_bridge_status_t;
+
+/** Applies gain and integration time settings, returns true on success */
+typedef bool (*veml7700_bridge_configure_t)(void *context, uint8_t gain,
+                                            uint8_t it);
+/** Takes a fresh reading, waiting as needed, returns true on success */
+typedef bool (*veml7700_bridge_measure_t)(void *context,
+                                          veml7700_log_record_t *record);
+/** Sends a reply payload to the host, as a stream packet */
+typedef void (*veml7700_bridge_send_t)(void *context, const uint8_t *payload,
+                                       size_t length);
+
+bool veml7700_bridge_parse_ack(const uint8_t *payload, size_t length,
+                               uint8_t *tag, uint8_t *status,
+                               uint8_t *executed);
+
+/*!
+ *    @brief  Runs command batches from a host against a sensor. The sensor
+ *            is reached through callbacks, so the same code drives the
+ *            driver on a board or the simulator on a host.
+ */
+class Adafruit_VEML7700_Bridge {
+public:
+  Adafruit_VEML7700_Bridge(veml7700_bridge_configure_t configure,
+                           veml7700_bridge_measure_t measure,
+                           veml7700_bridge_send_t send, void *context = NULL);
+
+  void push(uint8_t byte);
+  bool poll(void);
+
+  /*! @returns True while a burst is streaming */
+  bool bursting(void) const { return _bursting; }
+  /*! @returns Readings left in the burst, 0 for no limit */
+  uint16_t burstRemaining(void) const { return _remaining; }
+  /*! @returns Decoder of incoming packets, for its error counts */
+  const Adafruit_VEML7700_StreamDecoder &decoder(void) const {
+    return _decoder;
+  }
+
+private:
+  void execute(const uint8_t *payload, size_t length);
+  bool reading(void);
+
+  veml7700_bridge_configure_t _configure;
+  veml7700_bridge_measure_t _measure;
+  veml7700_bridge_send_t _send;
+  void *_context;
+  Adafruit_VEML7700_StreamDecoder _decoder;
+  uint16_t _sequence, _remaining;
+  bool _bursting;
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*!
+ *  @file Adafruit_VEML7700_Calibration.cpp
+ *
+ * 	Per unit calibration coefficients for the VEML7700
+ *
+ * 	Free of Arduino dependencies, so host tools can write blobs for boards
+ * 	to load.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Calibration.h"
+#include "Adafruit_VEML7700_Stream.h"
+#include <string.h>
+
+// The default correction must round exactly as veml7700_correct_lux() does,
+// see Adafruit_VEML7700_Lux.cpp, so multiplies and adds are never fused.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// the app note's non-linear correction, as in veml7700_correct_lux()
+static const float APP_NOTE_CORRECTION[4] = {6.0135e-13f, -9.3924e-9f,
+                                             8.1488e-5f, 1.0023f};
+
+static void putFloat(float value, uint8_t *buffer) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  for (uint8_t i = 0; i < 4; i++)
+    buffer[i] = bits >> (8 * i);
+}
+
+static float getFloat(const uint8_t *buffer) {
+  uint32_t bits = 0;
+  float value;
+  for (uint8_t i = 0; i < 4; i++)
+    bits |= (uint32_t)buffer[i] << (8 * i);
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/*!
+ *    @brief  Fill in the calibration of a nominal part
+ *    @param  calibration The calibration to fill in
+ */
+void veml7700_calibration_default(veml7700_calibration_t *calibration) {
+  calibration->scale = 1;
+  calibration->offset = 0;
+  memcpy(calibration->correction, APP_NOTE_CORRECTION,
+         sizeof(APP_NOTE_CORRECTION));
+}
+
+/*!
+ *    @brief  Check whether a calibration replaces the app note's correction
+ *    @param  calibration The calibration
+ *    @returns True if the correction coefficients differ from the default
+ */
+bool veml7700_calibration_custom(const veml7700_calibration_t *calibration) {
+  return memcmp(calibration->correction, APP_NOTE_CORRECTION,
+                sizeof(APP_NOTE_CORRECTION)) != 0;
+}
+
+/*!
+ *    @brief  Apply a calibration's non-linear correction to a linear lux
+ * value. With the default coefficients this matches veml7700_correct_lux().
+ *    @param  calibration The calibration
+ *    @param  lux Linear lux value
+ *    @returns Corrected lux value
+ */
+float veml7700_calibration_correct(const veml7700_calibration_t *calibration,
+                                   float lux) {
+  const float *c = calibration->correction;
+  return (((c[0] * lux + c[1]) * lux + c[2]) * lux + c[3]) * lux;
+}
+
+/*!
+ *    @brief  Write a calibration as a blob. The correction is left out if
+ * it is the default.
+ *    @param  calibration The calibration
+ *    @param  buffer Room for VEML7700_CALIBRATION_MAX bytes
+ *    @returns Number of bytes written
+ */
+size_t veml7700_calibration_encode(const veml7700_calibration_t *calibration,
+                                   uint8_t *buffer) {
+  bool custom = veml7700_calibration_custom(calibration);
+  size_t n = 0;
+
+  buffer[n++] = VEML7700_CALIBRATION_VERSION;
+  buffer[n++] = custom ? VEML7700_CALIBRATION_CUSTOM : 0;
+  putFloat(calibration->scale, buffer + n);
+  n += 4;
+  putFloat(calibration->offset, buffer + n);
+  n += 4;
+  if (custom) {
+    for (uint8_t i = 0; i < 4; i++, n += 4)
+      putFloat(calibration->correction[i], buffer + n);
+  }
+  uint16_t crc = veml7700_crc16(buffer, n);
+  buffer[n++] = crc;
+  buffer[n++] = crc >> 8;
+  return n;
+}
+
+/*!
+ *    @brief  Read a calibration from a blob
+ *    @param  blob The blob
+ *    @param  length Bytes in the blob
+ *    @param  calibration Filled in on success, untouched otherwise
+ *    @returns True if the blob is a valid calibration of this version
+ */
+bool veml7700_calibration_decode(const uint8_t *blob, size_t length,
+                                 veml7700_calibration_t *calibration) {
+  if ((length < 2) || (blob[0] != VEML7700_CALIBRATION_VERSION) ||
+      (blob[1] & ~VEML7700_CALIBRATION_CUSTOM))
+    return false;
+  bool custom = blob[1] & VEML7700_CALIBRATION_CUSTOM;
+  size_t n = custom ? VEML7700_CALIBRATION_MAX : 12;
+  if (length != n)
+    return false;
+  uint16_t crc = blob[n - 2] | ((uint16_t)blob[n - 1] << 8);
+  if (veml7700_crc16(blob, n - 2) != crc)
+    return false;
+
+  veml7700_calibration_default(calibration);
+  calibration->scale = getFloat(blob + 2);
+  calibration->offset = getFloat(blob + 6);
+  if (custom) {
+    for (uint8_t i = 0; i < 4; i++)
+      calibration->correction[i] = getFloat(blob + 10 + 4 * i);
+  }
+  return true;
+}
@@ -0,0 +1,63 @@
+/*!
+ *  @file Adafruit_VEML7700_Calibration.h
+ *
+ * 	Per unit calibration coefficients for the VEML7700, free of Arduino
+ * 	and bus dependencies
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_CALIBRATION_H
+#define _ADAFRUIT_VEML7700_CALIBRATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Calibration blob, all multi-byte values little endian, floats IEEE 754
+ * single precision:
+ *
+ *   version     VEML7700_CALIBRATION_VERSION
+ *   flags       VEML7700_CALIBRATION_CUSTOM if correction coefficients
+ *               follow
+ *   scale       4 bytes
+ *   offset      4 bytes
+ *   correction  4 coefficients, 16 bytes, only with the flag
+ *   crc         CRC-16/CCITT-FALSE of everything before it, 2 bytes
+ *
+ * That is 12 bytes for a gain and offset, 28 with a custom correction.
+ */
+
+#define VEML7700_CALIBRATION_VERSION 1   ///< Blob format version
+#define VEML7700_CALIBRATION_CUSTOM 0x01 ///< Blob flag for a correction
+#define VEML7700_CALIBRATION_MAX 28      ///< Largest blob in bytes
+
+/*!
+ *  @brief Per unit calibration. Lux is scale times the nominal resolution
+ *         times the count, plus offset, and the non-linear correction is
+ *         (((c[0] * lux + c[1]) * lux + c[2]) * lux + c[3]) * lux.
+ */
+typedef struct {
+  float scale;         ///< Multiplies the nominal resolution, 1 by default
+  float offset;        ///< Lux added to every linear value, 0 by default
+  float correction[4]; ///< Correction coefficients, the app note's default
+} veml7700_calibration_t;
+
+void veml7700_calibration_default(veml7700_calibration_t *calibration);
+bool veml7700_calibration_custom(const veml7700_calibration_t *calibration);
+float veml7700_calibration_correct(const veml7700_calibration_t *calibration,
+                                   float lux);
+size_t veml7700_calibration_encode(const veml7700_calibration_t *calibration,
+                                   uint8_t *buffer);
+bool veml7700_calibration_decode(const uint8_t *blob, size_t length,
+                                 veml7700_calibration_t *calibration);
+
+#endif
@@ -0,0 +1,87 @@
+/*!
+ *  @file Adafruit_VEML7700_Deadband.cpp
+ *
+ * 	Report by exception filter for VEML7700 readings
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Deadband.h"
+
+/*!
+ *    @brief  Instantiates a filter
+ *    @param  relative Deadband as a fraction of the last lux passed on
+ *    @param  absolute Deadband in lux, keeps noise in the dark from counting
+ *    @param  heartbeat Longest time in ms between readings passed on, 0 for
+ * none
+ */
+Adafruit_VEML7700_Deadband::Adafruit_VEML7700_Deadband(float relative,
+                                                       float absolute,
+                                                       uint32_t heartbeat) {
+  setDeadband(relative, absolute);
+  setHeartbeat(heartbeat);
+  reset();
+}
+
+/*!
+ *    @brief  Set the deadband. A reading must differ from the last one
+ * passed on by more than both limits to be passed on.
+ *    @param  relative Fraction of the magnitude of the last lux passed on
+ *    @param  absolute Lux
+ */
+void Adafruit_VEML7700_Deadband::setDeadband(float relative, float absolute) {
+  _relative = relative;
+  _absolute = absolute;
+}
+
+/*!
+ *    @brief  Set the heartbeat interval
+ *    @param  heartbeat Longest time in ms between readings passed on, 0 for
+ * none
+ */
+void Adafruit_VEML7700_Deadband::setHeartbeat(uint32_t heartbeat) {
+  _heartbeat = heartbeat;
+}
+
+/*!
+ *    @brief  Forget the last reading passed on, so the next one is passed on
+ */
+void Adafruit_VEML7700_Deadband::reset(void) {
+  _lux = 0;
+  _time = 0;
+  _primed = false;
+}
+
+/*!
+ *    @brief  Check whether a value should be passed on, and remember it if
+ * so
+ *    @param  lux The new value
+ *    @param  now Current time in ms, such as millis()
+ *    @returns True if the value should be passed on
+ */
+bool Adafruit_VEML7700_Deadband::check(float lux, uint32_t now) {
+  float delta = fabs(lux - _lux);
+  // a calibration offset can make lux negative, so the band is taken on
+  // its size, as in the Sampler
+  bool moved = (delta > _absolute) && (delta > _relative * fabs(_lux));
+  bool send = !_primed || moved || (_heartbeat && (now - _time >= _heartbeat));
+
+  if (send) {
+    _lux = lux;
+    _time = now;
+    _primed = true;
+  }
+  return send;
+}
+
+/*!
+ *    @brief  Check whether a reading should be passed on, and remember it if
+ * so
+ *    @param  reading The new reading, its timestamp is used as the time
+ *    @returns True if the reading should be passed on
+ */
+bool Adafruit_VEML7700_Deadband::check(const veml7700_reading_t *reading) {
+  if (!reading)
+    return false;
+  return check(reading->lux, reading->timestamp);
+}
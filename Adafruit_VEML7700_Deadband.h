@@ -0,0 +1,51 @@
+/*!
+ *  @file Adafruit_VEML7700_Deadband.h
+ *
+ * 	Report by exception filter for VEML7700 readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_DEADBAND_H
+#define _ADAFRUIT_VEML7700_DEADBAND_H
+
+#include "Adafruit_VEML7700.h"
+
+/*!
+ *    @brief  Decides which readings are worth sending. A reading is passed
+ *            on only when it leaves the deadband around the last reading
+ *            passed on, or when the heartbeat interval has gone by without
+ *            one, so receivers still know the sensor is alive.
+ */
+class Adafruit_VEML7700_Deadband {
+public:
+  Adafruit_VEML7700_Deadband(float relative = 0.05, float absolute = 0.5,
+                             uint32_t heartbeat = 600000);
+
+  void setDeadband(float relative, float absolute);
+  void setHeartbeat(uint32_t heartbeat);
+  void reset(void);
+
+  bool check(float lux, uint32_t now);
+  bool check(const veml7700_reading_t *reading);
+
+  /*! @returns Lux of the last reading passed on */
+  float lastLux(void) const { return _lux; }
+  /*! @returns Time of the last reading passed on */
+  uint32_t lastTime(void) const { return _time; }
+
+private:
+  float _relative, _absolute, _lux;
+  uint32_t _heartbeat, _time;
+  bool _primed;
+};
+
+#endif
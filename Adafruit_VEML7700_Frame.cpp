@@ -0,0 +1,441 @@
+/*!
+ *  @file Adafruit_VEML7700_Frame.cpp
+ *
+ * 	Bit packed, delta encoded radio frames of VEML7700 readings
+ *
+ * 	Everything but adding driver readings is free of Arduino dependencies
+ * 	so host side decoders build it unchanged.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Frame.h"
+#include <string.h>
+
+/*!
+ *    @brief  Map an integration time setting to its 3 bit index
+ *    @param  it Integration time setting, one of VEML7700_IT_*
+ *    @returns Index 0 to 5, or 0xFF for an invalid setting
+ */
+static uint8_t integrationTimeIndex(uint8_t it) {
+  if (it <= VEML7700_IT_800MS)
+    return it;
+  if ((it == VEML7700_IT_50MS) || (it == VEML7700_IT_25MS))
+    return (it >> 2) + 2;
+  return 0xFF;
+}
+
+/*!
+ *    @brief  Instantiates a builder and starts an empty frame
+ *    @param  buffer Where to build the frame
+ *    @param  size Most bytes the frame may take, such as the radio's
+ * maximum payload
+ *    @param  mode What each sample carries
+ *    @param  sensorBits Bits of sensor id per sample, 0 to 4. 0 for a
+ * single sensor.
+ *    @param  timeShift Times are sent in units of 2^timeShift ms, 0 to 15.
+ * Coarser units make samples smaller when sampling at a steady interval.
+ */
+Adafruit_VEML7700_FrameBuilder::Adafruit_VEML7700_FrameBuilder(
+    uint8_t *buffer, size_t size, veml7700_frame_mode_t mode,
+    uint8_t sensorBits, uint8_t timeShift)
+    : _buffer(buffer), _size(size), _mode(mode), _sensorBits(sensorBits),
+      _timeShift(timeShift) {
+  if (_sensorBits > 4)
+    _sensorBits = 4;
+  if (_timeShift > 15)
+    _timeShift = 15;
+  reset();
+}
+
+/*!
+ *    @brief  Start a new empty frame, after the previous one was sent
+ */
+void Adafruit_VEML7700_FrameBuilder::reset(void) {
+  _count = 0;
+  _seen = 0;
+  _last = 0;
+  _base = 0;
+  _bit = _start = VEML7700_FRAME_HEADER_SIZE * 8;
+  if (!_buffer || (_size < VEML7700_FRAME_HEADER_SIZE))
+    return;
+
+  memset(_buffer, 0, _size);
+  _buffer[0] = VEML7700_FRAME_VERSION | (_mode << 4);
+  _buffer[1] = _sensorBits | (_timeShift << 4);
+}
+
+/*!
+ *    @brief  Add a reading. In the lux modes it is converted to lux first.
+ *    @param  sensor Sensor id, below 2^sensorBits
+ *    @param  record The reading
+ *    @returns True if it was added. False if the frame is full, in which
+ * case the frame is unchanged and the reading should be added again after
+ * sending the frame and calling reset(). Also false for a bad sensor id or
+ * setting, or a time more than 2^30 units from the previous sample.
+ */
+bool Adafruit_VEML7700_FrameBuilder::add(uint8_t sensor,
+                                         const veml7700_log_record_t *record) {
+  if (!record)
+    return false;
+  if (_mode != VEML7700_FRAME_RAW)
+    return addLux(sensor, record->timestamp, veml7700_log_lux(record));
+
+  uint8_t index = integrationTimeIndex(record->integrationTime);
+  if ((index == 0xFF) || (record->gain > VEML7700_GAIN_1_4))
+    return false;
+  uint8_t config = record->gain | (index << 2) | (record->corrected << 5);
+
+  int32_t units;
+  if (!begin(sensor, record->timestamp, &units))
+    return false;
+
+  bool ok;
+  if (_seen & (1 << sensor)) {
+    bool changed = config != _config[sensor];
+    ok = put(changed, 1) && (!changed || put(config, 6)) &&
+         putSigned((int32_t)record->als - _als[sensor]) &&
+         putSigned((int32_t)record->white - _white[sensor]);
+  } else {
+    ok = put(config, 6) && put(record->als, 16) && put(record->white, 16);
+  }
+
+  if (!ok)
+    return false;
+  _config[sensor] = config;
+  _als[sensor] = record->als;
+  _white[sensor] = record->white;
+  commit(sensor, units);
+  return true;
+}
+
+/*!
+ *    @brief  Add a lux value, in the lux modes only. Useful for values that
+ * were already processed, such as calibrated or averaged lux.
+ *    @param  sensor Sensor id, below 2^sensorBits
+ *    @param  time Time of the value in ms
+ *    @param  lux Lux value
+ *    @returns True if it was added. False if the frame is full, in which
+ * case the frame is unchanged.
+ */
+bool Adafruit_VEML7700_FrameBuilder::addLux(uint8_t sensor, uint32_t time,
+                                            float lux) {
+  if (_mode == VEML7700_FRAME_RAW)
+    return false;
+
+  uint16_t code = (_mode == VEML7700_FRAME_LUX8) ? veml7700_lux_to_code8(lux)
+                                                  : veml7700_lux_to_code16(lux);
+  int32_t units;
+  if (!begin(sensor, time, &units))
+    return false;
+
+  bool ok;
+  if (_seen & (1 << sensor))
+    ok = putSigned((int32_t)code - _als[sensor]);
+  else
+    ok = put(code, (_mode == VEML7700_FRAME_LUX8) ? 8 : 16);
+
+  if (!ok)
+    return false;
+  _als[sensor] = code;
+  commit(sensor, units);
+  return true;
+}
+
+#if defined(ARDUINO)
+/*!
+ *    @brief  Add a reading from the driver. The lux modes send the reading's
+ * lux as the driver computed it.
+ *    @param  sensor Sensor id, below 2^sensorBits
+ *    @param  reading The reading
+ *    @returns True if it was added, see add()
+ */
+bool Adafruit_VEML7700_FrameBuilder::add(uint8_t sensor,
+                                         const veml7700_reading_t *reading) {
+  if (!reading)
+    return false;
+  if (_mode != VEML7700_FRAME_RAW)
+    return addLux(sensor, reading->timestamp, reading->lux);
+
+  veml7700_log_record_t record;
+  record.timestamp = reading->timestamp;
+  record.als = reading->als;
+  record.white = reading->white;
+  record.gain = reading->gain;
+  record.integrationTime = reading->integrationTime;
+  record.corrected = reading->corrected;
+  return add(sensor, &record);
+}
+#endif
+
+/*!
+ *    @brief  Fill in the sample count
+ *    @returns Length of the frame in bytes, 0 if it has no samples
+ */
+size_t Adafruit_VEML7700_FrameBuilder::finish(void) {
+  if (!_count)
+    return 0;
+  _buffer[6] = _count;
+  return length();
+}
+
+/*!
+ *    @brief  Write the sensor id and time of a new sample
+ *    @param  sensor Sensor id
+ *    @param  time Time of the sample in ms
+ *    @param  units Set to the sample's time in units since the frame start
+ *    @returns True if they fit. On false, the frame is left unchanged.
+ */
+bool Adafruit_VEML7700_FrameBuilder::begin(uint8_t sensor, uint32_t time,
+                                           int32_t *units) {
+  if (!_buffer || (_size < VEML7700_FRAME_HEADER_SIZE) ||
+      (sensor >= (1 << _sensorBits)) ||
+      (_count == VEML7700_FRAME_MAX_SAMPLES))
+    return false;
+
+  if (!_count) {
+    _base = time;
+    for (uint8_t i = 0; i < 4; i++)
+      _buffer[2 + i] = time >> (8 * i);
+  }
+
+  // rollback() returns here if the sample doesn't fit
+  _start = _bit;
+  *units = (int32_t)(time - _base) >> _timeShift;
+  return put(sensor, _sensorBits) && putSigned(*units - _last);
+}
+
+/*!
+ *    @brief  Count a sample once all of it fit
+ *    @param  sensor Sensor id
+ *    @param  units The sample's time in units since the frame start
+ */
+void Adafruit_VEML7700_FrameBuilder::commit(uint8_t sensor, int32_t units) {
+  _last = units;
+  _seen |= 1 << sensor;
+  _count++;
+}
+
+/*!
+ *    @brief  Append bits, least significant first. If they don't fit the
+ * sample in progress is removed.
+ *    @param  value Bits to append
+ *    @param  bits Number of bits, up to 32
+ *    @returns True if they fit
+ */
+bool Adafruit_VEML7700_FrameBuilder::put(uint32_t value, uint8_t bits) {
+  if (_bit + bits > _size * 8) {
+    rollback();
+    return false;
+  }
+  for (uint8_t i = 0; i < bits; i++, _bit++) {
+    if (value & ((uint32_t)1 << i))
+      _buffer[_bit >> 3] |= 1 << (_bit & 7);
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Remove the sample in progress, it goes in the next frame
+ */
+void Adafruit_VEML7700_FrameBuilder::rollback(void) {
+  for (size_t i = _start; i < _bit; i++)
+    _buffer[i >> 3] &= ~(1 << (i & 7));
+  _bit = _start;
+}
+
+/*!
+ *    @brief  Append an Elias gamma code, the length in unary then the bits
+ * below the leading 1
+ *    @param  value Value to append, 1 to 2^31 - 1
+ *    @returns True if it fit
+ */
+bool Adafruit_VEML7700_FrameBuilder::putGamma(uint32_t value) {
+  uint8_t length = 0;
+  while (value >> (length + 1))
+    length++;
+  return put(0, length) && put(1, 1) && put(value, length);
+}
+
+/*!
+ *    @brief  Append a signed change, zigzag mapped and gamma coded
+ *    @param  value Value to append
+ *    @returns True if it fit
+ */
+bool Adafruit_VEML7700_FrameBuilder::putSigned(int32_t value) {
+  uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  if (zigzag >= 0x7FFFFFFF) {
+    rollback();
+    return false;
+  }
+  return putGamma(zigzag + 1);
+}
+
+/*!
+ *    @brief  Instantiates a reader and checks the frame header
+ *    @param  data The frame
+ *    @param  length Length of the frame in bytes
+ */
+Adafruit_VEML7700_FrameReader::Adafruit_VEML7700_FrameReader(
+    const uint8_t *data, size_t length)
+    : _data(data), _length(length), _bit(VEML7700_FRAME_HEADER_SIZE * 8),
+      _mode(VEML7700_FRAME_RAW), _sensorBits(0), _timeShift(0), _count(0),
+      _read(0), _base(0), _last(0), _seen(0), _error(false) {
+  if (!data || (length < VEML7700_FRAME_HEADER_SIZE) ||
+      ((data[0] & 0x0F) != VEML7700_FRAME_VERSION) ||
+      ((data[0] >> 4) > VEML7700_FRAME_LUX8) || ((data[1] & 0x0F) > 4)) {
+    _error = true;
+    return;
+  }
+
+  _mode = (veml7700_frame_mode_t)(data[0] >> 4);
+  _sensorBits = data[1] & 0x0F;
+  _timeShift = data[1] >> 4;
+  for (uint8_t i = 0; i < 4; i++)
+    _base |= (uint32_t)data[2 + i] << (8 * i);
+  _count = data[6];
+}
+
+/*!
+ *    @brief  Decode the next sample
+ *    @param  sample Where to store the sample
+ *    @returns True if a sample was decoded, false at the end of the frame
+ * or on a malformed sample, see error()
+ */
+bool Adafruit_VEML7700_FrameReader::next(veml7700_frame_sample_t *sample) {
+  if (_error || (_read >= _count) || !sample)
+    return false;
+
+  uint32_t sensor;
+  int32_t delta;
+  if (!get(_sensorBits, &sensor) || !getSigned(&delta))
+    return false;
+  _last += delta;
+
+  memset(sample, 0, sizeof(*sample));
+  sample->sensor = sensor;
+  sample->record.timestamp = _base + ((uint32_t)_last << _timeShift);
+
+  bool seen = _seen & (1 << sensor);
+  uint32_t value;
+  int32_t change;
+
+  if (_mode == VEML7700_FRAME_RAW) {
+    uint32_t config = _config[sensor];
+    if (!seen || (get(1, &value) && value)) {
+      if (!get(6, &config))
+        return false;
+    }
+    if (_error)
+      return false;
+
+    uint8_t index = (config >> 2) & 0x07;
+    if (index > 5) {
+      _error = true;
+      return false;
+    }
+    _config[sensor] = config;
+    sample->record.gain = config & 0x03;
+    sample->record.integrationTime = (index < 4) ? index : (index - 2) << 2;
+    sample->record.corrected = config & 0x20;
+
+    if (seen) {
+      if (!getSigned(&change))
+        return false;
+      _als[sensor] += change;
+      if (!getSigned(&change))
+        return false;
+      _white[sensor] += change;
+    } else {
+      if (!get(16, &value))
+        return false;
+      _als[sensor] = value;
+      if (!get(16, &value))
+        return false;
+      _white[sensor] = value;
+    }
+    sample->record.als = _als[sensor];
+    sample->record.white = _white[sensor];
+    sample->lux = veml7700_log_lux(&sample->record);
+  } else {
+    bool lux8 = _mode == VEML7700_FRAME_LUX8;
+    int32_t code;
+    if (seen) {
+      if (!getSigned(&change))
+        return false;
+      code = (int32_t)_als[sensor] + change;
+    } else {
+      if (!get(lux8 ? 8 : 16, &value))
+        return false;
+      code = value;
+    }
+    if ((code < 0) || (code > (lux8 ? 0xFF : 0xFFFF))) {
+      _error = true;
+      return false;
+    }
+    _als[sensor] = code;
+    sample->lux = lux8 ? veml7700_code8_to_lux(code)
+                       : veml7700_code16_to_lux(code);
+  }
+
+  _seen |= 1 << sensor;
+  _read++;
+  return true;
+}
+
+/*!
+ *    @brief  Read bits, least significant first
+ *    @param  bits Number of bits, up to 32
+ *    @param  value Where to store them
+ *    @returns True on success, false and error() set past the end
+ */
+bool Adafruit_VEML7700_FrameReader::get(uint8_t bits, uint32_t *value) {
+  if (_bit + bits > _length * 8) {
+    _error = true;
+    return false;
+  }
+  *value = 0;
+  for (uint8_t i = 0; i < bits; i++, _bit++) {
+    if (_data[_bit >> 3] & (1 << (_bit & 7)))
+      *value |= (uint32_t)1 << i;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Read an Elias gamma code
+ *    @param  value Where to store it
+ *    @returns True on success
+ */
+bool Adafruit_VEML7700_FrameReader::getGamma(uint32_t *value) {
+  uint8_t length = 0;
+  uint32_t bit;
+  while (true) {
+    if (!get(1, &bit))
+      return false;
+    if (bit)
+      break;
+    if (++length > 30) {
+      _error = true;
+      return false;
+    }
+  }
+  if (!get(length, value))
+    return false;
+  *value |= (uint32_t)1 << length;
+  return true;
+}
+
+/*!
+ *    @brief  Read a zigzag mapped, gamma coded signed change
+ *    @param  value Where to store it
+ *    @returns True on success
+ */
+bool Adafruit_VEML7700_FrameReader::getSigned(int32_t *value) {
+  uint32_t zigzag;
+  if (!getGamma(&zigzag))
+    return false;
+  zigzag--;
+  *value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+  return true;
+}
@@ -0,0 +1,157 @@
+/*!
+ *  @file Adafruit_VEML7700_Frame.h
+ *
+ * 	Bit packed, delta encoded radio frames of readings from one or more
+ * 	VEML7700 sensors
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_FRAME_H
+#define _ADAFRUIT_VEML7700_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Adafruit_VEML7700_Log.h"
+#include "Adafruit_VEML7700_LuxCode.h"
+
+#if defined(ARDUINO)
+#include "Adafruit_VEML7700.h"
+#endif
+
+/*
+ * Format:
+ *
+ *   byte 0    bits 0-3 version, bits 4-5 mode
+ *   byte 1    bits 0-3 sensor id bits, bits 4-7 time shift
+ *   bytes 2-5 time of the first sample in ms, little endian
+ *   byte 6    number of samples
+ *   samples   bit packed, least significant bit first, then zero padding
+ *
+ * Each sample is
+ *
+ *   sensor    sensor id, in the header's number of bits
+ *   time      signed change in time since the previous sample, in units of
+ *             2^shift ms
+ *   config    raw mode only, a changed bit then 6 bits of gain (bits 0-1),
+ *             integration time index (bits 2-4) and corrected (bit 5), the
+ *             6 bits alone on a sensor's first sample
+ *   values    raw mode ALS then WHITE counts, lux modes the lux code. A
+ *             sensor's first sample in the frame carries them in full, 16
+ *             bits or 8 for VEML7700_FRAME_LUX8, later ones as signed
+ *             changes from that sensor's previous sample.
+ *
+ * Signed changes are zigzag mapped to unsigned and sent as Elias gamma
+ * codes, 1 bit for no change and 3 bits for +-1. Frames decode on their own
+ * so a lost frame loses only its samples. In 51 byte frames, steady light
+ * from one sensor sampled every second with a 1024ms time unit takes about
+ * 2 bytes a sample in raw mode, 1.3 in VEML7700_FRAME_LUX16 and 0.6 in
+ * VEML7700_FRAME_LUX8. Each sensor's first sample in a frame costs more, so
+ * many sensors per frame pay off most in the lux modes.
+ */
+
+#define VEML7700_FRAME_VERSION 1       ///< Format version in the header
+#define VEML7700_FRAME_HEADER_SIZE 7   ///< Bytes in the frame header
+#define VEML7700_FRAME_SENSORS 16      ///< Most sensor ids in one frame
+#define VEML7700_FRAME_MAX_SAMPLES 255 ///< Most samples in one frame
+
+/** What each sample of a frame carries */
+typedef enum {
+  VEML7700_FRAME_RAW,   ///< Raw ALS and WHITE counts with their settings
+  VEML7700_FRAME_LUX16, ///< 16 bit log encoded lux
+  VEML7700_FRAME_LUX8,  ///< 8 bit log encoded lux
+} veml7700_frame_mode_t;
+
+/** One decoded sample */
+typedef struct {
+  uint8_t sensor;               ///< Sensor id
+  veml7700_log_record_t record; ///< Time, and in raw mode counts & settings
+  float lux;                    ///< Lux, computed from counts in raw mode
+} veml7700_frame_sample_t;
+
+/*!
+ *    @brief  Packs readings into a caller supplied buffer of a fixed size,
+ *            such as a radio payload
+ */
+class Adafruit_VEML7700_FrameBuilder {
+public:
+  Adafruit_VEML7700_FrameBuilder(uint8_t *buffer, size_t size,
+                                 veml7700_frame_mode_t mode,
+                                 uint8_t sensorBits = 0,
+                                 uint8_t timeShift = 0);
+
+  void reset(void);
+  bool add(uint8_t sensor, const veml7700_log_record_t *record);
+  bool addLux(uint8_t sensor, uint32_t time, float lux);
+#if defined(ARDUINO)
+  bool add(uint8_t sensor, const veml7700_reading_t *reading);
+#endif
+  size_t finish(void);
+
+  /*! @returns Number of samples in the frame */
+  uint8_t count(void) const { return _count; }
+  /*! @returns Bytes used so far, including the header and padding */
+  size_t length(void) const { return (_bit + 7) / 8; }
+
+private:
+  bool begin(uint8_t sensor, uint32_t time, int32_t *units);
+  void commit(uint8_t sensor, int32_t units);
+  void rollback(void);
+  bool put(uint32_t value, uint8_t bits);
+  bool putGamma(uint32_t value);
+  bool putSigned(int32_t value);
+
+  uint8_t *_buffer;
+  size_t _size, _bit, _start; // _start is where the current sample began
+  veml7700_frame_mode_t _mode;
+  uint8_t _sensorBits, _timeShift, _count;
+  uint32_t _base;
+  int32_t _last;  // time of the last sample in units since _base
+  uint16_t _seen; // bit per sensor that has a sample in the frame
+  uint16_t _als[VEML7700_FRAME_SENSORS], _white[VEML7700_FRAME_SENSORS];
+  uint8_t _config[VEML7700_FRAME_SENSORS];
+};
+
+/*!
+ *    @brief  Decodes the samples of a frame held in memory
+ */
+class Adafruit_VEML7700_FrameReader {
+public:
+  Adafruit_VEML7700_FrameReader(const uint8_t *data, size_t length);
+
+  bool next(veml7700_frame_sample_t *sample);
+
+  /*! @returns True if the header or a sample was malformed */
+  bool error(void) const { return _error; }
+  /*! @returns The frame's mode */
+  veml7700_frame_mode_t mode(void) const { return _mode; }
+  /*! @returns Number of samples in the frame */
+  uint8_t count(void) const { return _count; }
+
+private:
+  bool get(uint8_t bits, uint32_t *value);
+  bool getGamma(uint32_t *value);
+  bool getSigned(int32_t *value);
+
+  const uint8_t *_data;
+  size_t _length, _bit;
+  veml7700_frame_mode_t _mode;
+  uint8_t _sensorBits, _timeShift, _count, _read;
+  uint32_t _base;
+  int32_t _last;
+  uint16_t _seen;
+  uint16_t _als[VEML7700_FRAME_SENSORS], _white[VEML7700_FRAME_SENSORS];
+  uint8_t _config[VEML7700_FRAME_SENSORS];
+  bool _error;
+};
+
+#endif
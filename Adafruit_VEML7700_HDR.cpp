@@ -0,0 +1,134 @@
+/*!
+ *  @file Adafruit_VEML7700_HDR.cpp
+ *
+ * 	High dynamic range readings from two alternating VEML7700 exposures
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_HDR.h"
+
+/*!
+ *    @brief  Instantiates a fuser for a sensor that has been begin()'d. The
+ * default exposures are gain 2 at 100ms, linear up to about 290 lux, and
+ * gain 1/8 at 25ms, which counts 100 or more above about 185 lux and reaches
+ * full scale.
+ *    @param  sensor The sensor to drive
+ */
+Adafruit_VEML7700_HDR::Adafruit_VEML7700_HDR(Adafruit_VEML7700 *sensor)
+    : _sensor(sensor), _linearMax(VEML7700_HDR_LINEAR_MAX) {
+  setExposures(VEML7700_GAIN_2, VEML7700_IT_100MS, VEML7700_GAIN_1_8,
+               VEML7700_IT_25MS);
+}
+
+/*!
+ *    @brief  Set the two exposures. Their linear regions should overlap, so
+ * some light level suits both. Starts over with the sensitive exposure.
+ *    @param  sensitiveGain Gain of the exposure used in low light
+ *    @param  sensitiveIt Integration time of the exposure used in low light
+ *    @param  rangeGain Gain of the exposure used in bright light
+ *    @param  rangeIt Integration time of the exposure used in bright light
+ */
+void Adafruit_VEML7700_HDR::setExposures(uint8_t sensitiveGain,
+                                         uint8_t sensitiveIt,
+                                         uint8_t rangeGain, uint8_t rangeIt) {
+  _sensitiveGain = sensitiveGain;
+  _sensitiveIt = sensitiveIt;
+  _rangeGain = rangeGain;
+  _rangeIt = rangeIt;
+  reset();
+}
+
+/*!
+ *    @brief  Set the highest sensitive count still in the linear region
+ *    @param  counts Raw ALS count, VEML7700_HDR_LINEAR_MAX by default as in
+ * the app note's auto-ranging
+ */
+void Adafruit_VEML7700_HDR::setLinearMax(uint16_t counts) {
+  _linearMax = counts;
+}
+
+/*!
+ *    @brief  Forget both exposures. The next update() starts the sensitive
+ * one.
+ */
+void Adafruit_VEML7700_HDR::reset(void) {
+  _started = false;
+  _sensitiveValid = false;
+  _fromSensitive = false;
+  _lux = 0;
+}
+
+/*!
+ *    @brief  Call this often, from loop(). Reads the exposure being
+ * integrated once it is ready and starts the other one.
+ *    @param  reading Optional pointer to receive the new reading. Its gain,
+ * integration time and counts are those of the exposure it came from.
+ *    @returns True if a reading was completed
+ */
+bool Adafruit_VEML7700_HDR::update(veml7700_reading_t *reading) {
+  if (!_sensor)
+    return false;
+  if (!_started) {
+    expose(true);
+    _started = true;
+    return false;
+  }
+  if (millis() - _switched < _settle)
+    return false;
+
+  // the app note corrects every count it takes above gain 1/8's floor.
+  // Either way the driver converts, so the sensor's calibration applies.
+  bool wasSensitive = _exposing;
+  veml7700_reading_t current;
+  luxMethod method =
+      wasSensitive ? VEML_LUX_NORMAL_NOWAIT : VEML_LUX_CORRECTED_NOWAIT;
+  if (!_sensor->getReading(&current, method))
+    return false;
+  expose(!wasSensitive);
+
+  bool use;
+  if (wasSensitive) {
+    _sensitiveValid = current.als <= _linearMax;
+    use = _sensitiveValid;
+  } else {
+    use = !_sensitiveValid;
+  }
+  if (!use)
+    return false;
+
+  _fromSensitive = wasSensitive;
+  _lux = current.lux;
+  if (reading)
+    *reading = current;
+  return true;
+}
+
+/*!
+ *    @brief  Switch the sensor to an exposure, writing only the settings
+ * that change
+ *    @param  sensitive True for the sensitive exposure
+ */
+void Adafruit_VEML7700_HDR::expose(bool sensitive) {
+  uint8_t gain = sensitive ? _sensitiveGain : _rangeGain;
+  uint8_t it = sensitive ? _sensitiveIt : _rangeIt;
+  uint8_t previousGain = sensitive ? _rangeGain : _sensitiveGain;
+  uint8_t previousIt = sensitive ? _rangeIt : _sensitiveIt;
+
+  // on the first exposure the sensor's settings are unknown
+  if (!_started) {
+    previousGain = 0xFF;
+    previousIt = VEML7700_IT_800MS;
+  }
+  if (gain != previousGain)
+    _sensor->setGain(gain);
+  if (!_started || (it != previousIt))
+    _sensor->setIntegrationTime(it, false);
+
+  // the same settling setIntegrationTime() and readWait() block for: the
+  // cycle in progress, then twice the new integration time
+  _settle = veml7700_integration_time_value(previousIt) +
+            2 * veml7700_integration_time_value(it);
+  _switched = millis();
+  _exposing = sensitive;
+}
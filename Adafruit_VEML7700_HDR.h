@@ -0,0 +1,62 @@
+/*!
+ *  @file Adafruit_VEML7700_HDR.h
+ *
+ * 	High dynamic range readings from two alternating VEML7700 exposures
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_HDR_H
+#define _ADAFRUIT_VEML7700_HDR_H
+
+#include "Adafruit_VEML7700.h"
+
+#define VEML7700_HDR_LINEAR_MAX 10000 ///< Default top of the linear region
+
+/*!
+ *    @brief  Alternates the sensor between a sensitive exposure and a wide
+ *            range exposure on consecutive integrations, and fuses them into
+ *            one stream. Each cycle gives one reading, from the sensitive
+ *            exposure while its count is in the linear region and from the
+ *            wide range exposure otherwise, so the light can swing between
+ *            dark and bright without ever stopping to re-range. update()
+ *            never blocks.
+ */
+class Adafruit_VEML7700_HDR {
+public:
+  Adafruit_VEML7700_HDR(Adafruit_VEML7700 *sensor);
+
+  void setExposures(uint8_t sensitiveGain, uint8_t sensitiveIt,
+                    uint8_t rangeGain, uint8_t rangeIt);
+  void setLinearMax(uint16_t counts);
+  void reset(void);
+
+  bool update(veml7700_reading_t *reading = NULL);
+
+  /*! @returns True if the last reading came from the sensitive exposure */
+  bool sensitive(void) const { return _fromSensitive; }
+  /*! @returns Lux of the last reading */
+  float lastLux(void) const { return _lux; }
+
+private:
+  void expose(bool sensitive);
+
+  Adafruit_VEML7700 *_sensor;
+  uint8_t _sensitiveGain, _sensitiveIt, _rangeGain, _rangeIt;
+  uint16_t _linearMax;
+  bool _exposing;       // exposure being integrated, true for sensitive
+  bool _sensitiveValid; // last sensitive count was in the linear region
+  bool _started, _fromSensitive;
+  unsigned long _switched, _settle;
+  float _lux;
+};
+
+#endif
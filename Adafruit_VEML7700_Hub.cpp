@@ -0,0 +1,199 @@
+/*!
+ *  @file Adafruit_VEML7700_Hub.cpp
+ *
+ * 	Seqlock protected publication of the latest VEML7700 readings
+ *
+ * 	Each slot carries a sequence counter that is odd while its writer is
+ * 	updating the reading. Readers sample the counter before and after
+ * 	copying the reading and only accept the copy if both samples match and
+ * 	are even, so a reader never blocks the writer and never sees a torn
+ * 	reading.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Hub.h"
+#include <string.h>
+
+// Accesses to the sequence counter. Readers only need the counter loads
+// ordered against their copy of the reading, and the writer its counter
+// stores against its copy, so acquire and release suffice and cost no
+// barrier instructions at all on x86. AVR is single core, so only the
+// compiler needs to be kept from reordering.
+#if defined(__AVR__)
+#define VEML7700_HUB_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static inline veml7700_seq_t loadAcquire(const volatile veml7700_seq_t *seq) {
+  veml7700_seq_t value = *seq;
+  VEML7700_HUB_BARRIER();
+  return value;
+}
+static inline veml7700_seq_t loadRelaxed(const volatile veml7700_seq_t *seq) {
+  return *seq;
+}
+static inline void storeRelease(volatile veml7700_seq_t *seq,
+                                veml7700_seq_t value) {
+  VEML7700_HUB_BARRIER();
+  *seq = value;
+}
+static inline void storeRelaxed(volatile veml7700_seq_t *seq,
+                                veml7700_seq_t value) {
+  *seq = value;
+}
+static inline void fenceAcquire(void) { VEML7700_HUB_BARRIER(); }
+static inline void fenceRelease(void) { VEML7700_HUB_BARRIER(); }
+#else
+static inline veml7700_seq_t loadAcquire(const volatile veml7700_seq_t *seq) {
+  return __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+}
+static inline veml7700_seq_t loadRelaxed(const volatile veml7700_seq_t *seq) {
+  return __atomic_load_n(seq, __ATOMIC_RELAXED);
+}
+static inline void storeRelease(volatile veml7700_seq_t *seq,
+                                veml7700_seq_t value) {
+  __atomic_store_n(seq, value, __ATOMIC_RELEASE);
+}
+static inline void storeRelaxed(volatile veml7700_seq_t *seq,
+                                veml7700_seq_t value) {
+  __atomic_store_n(seq, value, __ATOMIC_RELAXED);
+}
+static inline void fenceAcquire(void) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+static inline void fenceRelease(void) {
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+#endif
+
+/*!
+ *    @brief  Instantiates a hub over an array of slots
+ *    @param  slots Array of slots to publish into. This may be placed in
+ * memory shared with other tasks or processes, each of which creates its own
+ * hub over the same array.
+ *    @param  count Number of slots in the array
+ */
+Adafruit_VEML7700_Hub::Adafruit_VEML7700_Hub(veml7700_hub_slot_t *slots,
+                                             uint16_t count)
+    : _slots(slots), _count(slots ? count : 0) {}
+
+/*!
+ *    @brief  Reset every slot to an empty, never published state. Only call
+ * this while no readers or writers are active.
+ */
+void Adafruit_VEML7700_Hub::clear(void) {
+  for (uint16_t i = 0; i < _count; i++) {
+    _slots[i].sequence = 0;
+    memset(&_slots[i].reading, 0, sizeof(veml7700_reading_t));
+  }
+}
+
+/*!
+ *    @brief  Publish a reading into a slot
+ *    @param  index Slot to publish into
+ *    @param  reading The reading to publish
+ *    @returns True on success, false if index is out of range
+ */
+bool Adafruit_VEML7700_Hub::publish(uint16_t index,
+                                    const veml7700_reading_t *reading) {
+  if ((index >= _count) || !reading)
+    return false;
+
+  veml7700_hub_slot_t *slot = &_slots[index];
+  veml7700_seq_t seq = loadRelaxed(&slot->sequence); // only writer
+  veml7700_seq_t next = seq + 2;
+
+  if (next == 0)
+    next = 2; // 0 is reserved for never published
+
+  storeRelaxed(&slot->sequence, seq + 1); // odd, update in progress
+  fenceRelease(); // the odd value is seen before any of the copy
+  memcpy(&slot->reading, reading, sizeof(veml7700_reading_t));
+  storeRelease(&slot->sequence, next); // even, after all of the copy
+
+  return true;
+}
+
+#if defined(ARDUINO)
+
+/*!
+ *    @brief  Take a reading from a sensor and publish it
+ *    @param  index Slot to publish into
+ *    @param  sensor The sensor to read
+ *    @param  method Lux computation method to use
+ *    @returns True on success, false on a bad index or failed reading
+ */
+bool Adafruit_VEML7700_Hub::update(uint16_t index, Adafruit_VEML7700 *sensor,
+                                   luxMethod method) {
+  veml7700_reading_t reading;
+
+  if ((index >= _count) || !sensor || !sensor->getReading(&reading, method))
+    return false;
+
+  return publish(index, &reading);
+}
+
+#endif
+
+/*!
+ *    @brief  Make a single attempt at copying out the latest reading of a
+ * slot. This is wait-free: it never loops, so it is safe to call from an
+ * interrupt handler that may have preempted the writer.
+ *    @param  index Slot to read
+ *    @param  reading Where to copy the reading
+ *    @returns True if a consistent reading was copied, false if the slot
+ * was being updated, has never been published, or index is out of range
+ */
+bool Adafruit_VEML7700_Hub::tryRead(uint16_t index,
+                                    veml7700_reading_t *reading) const {
+  if ((index >= _count) || !reading)
+    return false;
+
+  const veml7700_hub_slot_t *slot = &_slots[index];
+  veml7700_seq_t before = loadAcquire(&slot->sequence);
+
+  if ((before == 0) || (before & 1))
+    return false;
+
+  memcpy(reading, (const void *)&slot->reading, sizeof(veml7700_reading_t));
+  fenceAcquire(); // all of the copy is done before the check
+
+  return loadRelaxed(&slot->sequence) == before;
+}
+
+/*!
+ *    @brief  Copy out the latest reading of a slot, retrying while the
+ * writer is mid update. Do not call this from a context that preempts the
+ * writer, use tryRead() there instead. If the writer is another process,
+ * it may die mid update and leave the slot odd for good, so give a limit
+ * to tries there.
+ *    @param  index Slot to read
+ *    @param  reading Where to copy the reading
+ *    @param  tries Most attempts to make, 0 to retry until a consistent
+ * reading is copied
+ *    @returns True if a consistent reading was copied, false if the slot has
+ * never been published, tries ran out or index is out of range
+ */
+bool Adafruit_VEML7700_Hub::read(uint16_t index, veml7700_reading_t *reading,
+                                 uint32_t tries) const {
+  if ((index >= _count) || !reading)
+    return false;
+
+  while (!tryRead(index, reading)) {
+    if ((sequence(index) == 0) || (tries && !--tries))
+      return false;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Get the sequence counter of a slot. Readers can compare this
+ * against a previously seen value to cheaply detect a new reading.
+ *    @param  index Slot to query
+ *    @returns The sequence counter, which is 0 for a never published slot
+ * and advances by 2 for every publish, skipping 0 when it wraps
+ */
+veml7700_seq_t Adafruit_VEML7700_Hub::sequence(uint16_t index) const {
+  if (index >= _count)
+    return 0;
+  return loadAcquire(&_slots[index].sequence);
+}
@@ -0,0 +1,80 @@
+/*!
+ *  @file Adafruit_VEML7700_Hub.h
+ *
+ * 	Seqlock protected publication of the latest VEML7700 readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_HUB_H
+#define _ADAFRUIT_VEML7700_HUB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Adafruit_VEML7700_Lux.h"
+
+#if defined(ARDUINO)
+#include "Adafruit_VEML7700.h"
+#endif
+
+/*!
+ *  @brief Sequence counter type. 8-bit AVRs can not load a wider value
+ *         atomically, so a single byte is used there. It comes back to the
+ *         same value every 127 publishes, so a reader stalled that long
+ *         mid copy, such as loop() code interrupted by a handler that
+ *         publishes, can accept a torn reading. Keep publishes from
+ *         interrupt handlers well under 127 per read there.
+ */
+#if defined(__AVR__)
+typedef uint8_t veml7700_seq_t;
+#else
+typedef uint32_t veml7700_seq_t;
+#endif
+
+/** One published reading, guarded by its own sequence counter */
+typedef struct {
+  volatile veml7700_seq_t sequence; ///< Odd while an update is in progress
+  veml7700_reading_t reading;       ///< Latest published reading
+} veml7700_hub_slot_t;
+
+/*!
+ *    @brief  Publishes the latest reading of any number of sensors into a
+ *            caller supplied array of slots. There must be only one writer
+ *            per slot, but any number of readers (interrupt handlers, other
+ *            tasks, or other processes when the slots live in shared memory)
+ *            can fetch readings without locking and without touching the bus.
+ *            Only update() needs the driver, so on a host the hub builds
+ *            without Arduino for processes that share the slots.
+ */
+class Adafruit_VEML7700_Hub {
+public:
+  Adafruit_VEML7700_Hub(veml7700_hub_slot_t *slots, uint16_t count);
+
+  void clear(void);
+  bool publish(uint16_t index, const veml7700_reading_t *reading);
+#if defined(ARDUINO)
+  bool update(uint16_t index, Adafruit_VEML7700 *sensor,
+              luxMethod method = VEML_LUX_NORMAL);
+#endif
+
+  bool tryRead(uint16_t index, veml7700_reading_t *reading) const;
+  bool read(uint16_t index, veml7700_reading_t *reading,
+            uint32_t tries = 0) const;
+  veml7700_seq_t sequence(uint16_t index) const;
+  uint16_t count(void) const { return _count; } ///< @returns Number of slots
+
+private:
+  veml7700_hub_slot_t *_slots;
+  uint16_t _count;
+};
+
+#endif
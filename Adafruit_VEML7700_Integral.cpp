@@ -0,0 +1,211 @@
+/*!
+ *  @file Adafruit_VEML7700_Integral.cpp
+ *
+ * 	Light integral and daily light integral accumulator for VEML7700
+ * 	readings
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Integral.h"
+
+// twice millilux ms in a lux hour
+#define TWICE_MILLILUX_MS_PER_LUX_HOUR 7.2e9
+
+/*!
+ *    @brief  Instantiates an accumulator, with days starting at time 0
+ *    @param  maxGap Longest time in ms between readings to integrate over,
+ * longer gaps are skipped as missing data, 0 for no limit
+ */
+Adafruit_VEML7700_Integral::Adafruit_VEML7700_Integral(uint32_t maxGap) {
+  setMaxGap(maxGap);
+  _ppfdPerLux = VEML7700_PPFD_PER_LUX_SUN;
+  _dayEnd = VEML7700_DAY_MS;
+  _dayLength = VEML7700_DAY_MS;
+  reset();
+}
+
+/*!
+ *    @brief  Set the longest time between readings to integrate over
+ *    @param  maxGap Time in ms, 0 for no limit
+ */
+void Adafruit_VEML7700_Integral::setMaxGap(uint32_t maxGap) {
+  _maxGap = maxGap;
+}
+
+/*!
+ *    @brief  Set where days begin. Today's sums carry on into the day that
+ * contains the next reading, so days that would have ended before the last
+ * reading are skipped rather than closed.
+ *    @param  dayStart A time in ms at which a day begins, such as the
+ * millis() of local midnight from a clock
+ *    @param  dayLength Length of a day in ms
+ */
+void Adafruit_VEML7700_Integral::setDay(uint32_t dayStart,
+                                        uint32_t dayLength) {
+  if (!dayLength)
+    return;
+  _dayLength = dayLength;
+  _dayEnd = dayStart + dayLength;
+  // a dayStart days back must not close days before the next reading
+  if (_primed) {
+    while ((int32_t)(_time - _dayEnd) >= 0)
+      _dayEnd += _dayLength;
+  }
+}
+
+/*!
+ *    @brief  Set the conversion from lux to photosynthetic photon flux used
+ * by dli(), which depends on the light source
+ *    @param  factor umol/m^2/s per lux, VEML7700_PPFD_PER_LUX_SUN by default
+ */
+void Adafruit_VEML7700_Integral::setPPFDPerLux(float factor) {
+  _ppfdPerLux = factor;
+}
+
+/*!
+ *    @brief  Clear all sums and forget the last reading
+ */
+void Adafruit_VEML7700_Integral::reset(void) {
+  _today = _previous = _total = 0;
+  _time = _millilux = 0;
+  _covered = _previousCovered = _days = 0;
+  _primed = false;
+}
+
+/*!
+ *    @brief  Add a value, integrating from the previous one
+ *    @param  millilux The new value, such as from veml7700_raw_to_millilux()
+ *    @param  now Current time in ms, such as millis()
+ *    @returns True if a day ended since the previous value
+ */
+bool Adafruit_VEML7700_Integral::addMilliLux(uint32_t millilux,
+                                             uint32_t now) {
+  bool ended = false;
+
+  if (!_primed) {
+    _time = now;
+    _millilux = millilux;
+    _primed = true;
+    // days before the first value are not counted
+    while ((int32_t)(now - _dayEnd) >= 0)
+      _dayEnd += _dayLength;
+  }
+
+  uint32_t dt = now - _time;
+  bool gap = _maxGap && (dt > _maxGap);
+  uint32_t t = _time;
+  uint32_t m = _millilux;
+
+  // close every day boundary at or before now, splitting the interval at
+  // the value interpolated there
+  while ((int32_t)(now - _dayEnd) >= 0) {
+    uint32_t part = _dayEnd - t;
+    uint32_t boundary = m;
+    if (!gap && dt) {
+      int64_t delta = (int64_t)millilux - _millilux;
+      boundary = _millilux + delta * (int64_t)(_dayEnd - _time) / dt;
+      integrate(part, m, boundary);
+    }
+    t = _dayEnd;
+    m = boundary;
+    _previous = _today;
+    _previousCovered = _covered;
+    _today = 0;
+    _covered = 0;
+    _days++;
+    _dayEnd += _dayLength;
+    ended = true;
+  }
+  if (!gap)
+    integrate(now - t, m, millilux);
+
+  _time = now;
+  _millilux = millilux;
+  return ended;
+}
+
+/*!
+ *    @brief  Add a value, integrating from the previous one
+ *    @param  lux The new value
+ *    @param  now Current time in ms, such as millis()
+ *    @returns True if a day ended since the previous value
+ */
+bool Adafruit_VEML7700_Integral::add(float lux, uint32_t now) {
+  uint32_t millilux;
+
+  if (!(lux > 0))
+    millilux = 0;
+  else if (lux >= 4294967.0)
+    millilux = 0xFFFFFFFF;
+  else
+    millilux = lux * 1000 + 0.5;
+  return addMilliLux(millilux, now);
+}
+
+/*!
+ *    @brief  Add a reading, integrating from the previous one
+ *    @param  reading The new reading, its timestamp is used as the time
+ *    @returns True if a day ended since the previous reading
+ */
+bool Adafruit_VEML7700_Integral::add(const veml7700_reading_t *reading) {
+  if (!reading)
+    return false;
+  return add(reading->lux, reading->timestamp);
+}
+
+/*!
+ *    @brief  Add one trapezoid to the sums
+ *    @param  dt Width in ms
+ *    @param  m0 Millilux at the start
+ *    @param  m1 Millilux at the end
+ */
+void Adafruit_VEML7700_Integral::integrate(uint32_t dt, uint32_t m0,
+                                           uint32_t m1) {
+  // kept doubled so the halving never rounds
+  uint64_t area = ((uint64_t)m0 + m1) * dt;
+  _today += area;
+  _total += area;
+  _covered += dt;
+}
+
+/*!
+ *    @brief  Light integral so far today
+ *    @returns Lux hours
+ */
+float Adafruit_VEML7700_Integral::luxHours(void) const {
+  return _today / TWICE_MILLILUX_MS_PER_LUX_HOUR;
+}
+
+/*!
+ *    @brief  Daily light integral so far today
+ *    @returns mol/m^2
+ */
+float Adafruit_VEML7700_Integral::dli(void) const {
+  // lux hours to lux seconds, umol to mol
+  return luxHours() * 3600 * _ppfdPerLux / 1e6;
+}
+
+/*!
+ *    @brief  Light integral of the previous day
+ *    @returns Lux hours, 0 before the first day ends
+ */
+float Adafruit_VEML7700_Integral::previousLuxHours(void) const {
+  return _previous / TWICE_MILLILUX_MS_PER_LUX_HOUR;
+}
+
+/*!
+ *    @brief  Daily light integral of the previous day
+ *    @returns mol/m^2, 0 before the first day ends
+ */
+float Adafruit_VEML7700_Integral::previousDLI(void) const {
+  return previousLuxHours() * 3600 * _ppfdPerLux / 1e6;
+}
+
+/*!
+ *    @brief  Light integral since reset()
+ *    @returns Lux hours
+ */
+float Adafruit_VEML7700_Integral::totalLuxHours(void) const {
+  return _total / TWICE_MILLILUX_MS_PER_LUX_HOUR;
+}
@@ -0,0 +1,71 @@
+/*!
+ *  @file Adafruit_VEML7700_Integral.h
+ *
+ * 	Light integral and daily light integral accumulator for VEML7700
+ * 	readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_INTEGRAL_H
+#define _ADAFRUIT_VEML7700_INTEGRAL_H
+
+#include "Adafruit_VEML7700.h"
+
+#define VEML7700_DAY_MS 86400000UL ///< Milliseconds in a day
+
+/// Photosynthetic photon flux per lux of sunlight, in umol/m^2/s
+#define VEML7700_PPFD_PER_LUX_SUN 0.0185
+
+/*!
+ *    @brief  Integrates lux over the time between readings, by the
+ *            trapezoidal rule on the readings' own timestamps. Sums are
+ *            kept exactly in 64 bit millilux milliseconds, so they neither
+ *            drift nor overflow, and are split into days at a boundary the
+ *            caller sets, such as local midnight.
+ */
+class Adafruit_VEML7700_Integral {
+public:
+  Adafruit_VEML7700_Integral(uint32_t maxGap = 60000);
+
+  void setMaxGap(uint32_t maxGap);
+  void setDay(uint32_t dayStart, uint32_t dayLength = VEML7700_DAY_MS);
+  void setPPFDPerLux(float factor);
+  void reset(void);
+
+  bool addMilliLux(uint32_t millilux, uint32_t now);
+  bool add(float lux, uint32_t now);
+  bool add(const veml7700_reading_t *reading);
+
+  float luxHours(void) const;
+  float dli(void) const;
+  float previousLuxHours(void) const;
+  float previousDLI(void) const;
+  float totalLuxHours(void) const;
+
+  /*! @returns Time in ms integrated today, excluding gaps */
+  uint32_t coveredMillis(void) const { return _covered; }
+  /*! @returns Time in ms integrated on the previous day, excluding gaps */
+  uint32_t previousCoveredMillis(void) const { return _previousCovered; }
+  /*! @returns Number of day boundaries passed since reset() */
+  uint32_t days(void) const { return _days; }
+
+private:
+  void integrate(uint32_t dt, uint32_t m0, uint32_t m1);
+
+  uint64_t _today, _previous, _total; // twice millilux ms
+  uint32_t _maxGap, _dayEnd, _dayLength;
+  uint32_t _time, _millilux, _covered, _previousCovered, _days;
+  float _ppfdPerLux;
+  bool _primed;
+};
+
+#endif
@@ -0,0 +1,227 @@
+/*!
+ *  @file Adafruit_VEML7700_Log.cpp
+ *
+ * 	Compact append-only binary log of raw VEML7700 readings
+ *
+ * 	Raw counts are logged rather than lux so logs can be reprocessed later
+ * 	with improved corrections. Everything but the writer is free of
+ * 	Arduino dependencies, so host tools build it unchanged.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Log.h"
+
+/*!
+ *    @brief  Encode the file header
+ *    @param  buffer Room for VEML7700_LOG_HEADER_SIZE bytes
+ *    @returns Number of bytes encoded
+ */
+uint8_t veml7700_log_header(uint8_t *buffer) {
+  buffer[0] = 'V';
+  buffer[1] = 'E';
+  buffer[2] = 'M';
+  buffer[3] = 'L';
+  buffer[4] = VEML7700_LOG_VERSION;
+  buffer[5] = buffer[6] = buffer[7] = 0;
+  return VEML7700_LOG_HEADER_SIZE;
+}
+
+/*!
+ *    @brief  Encode a time record
+ *    @param  time Absolute time in ms
+ *    @param  buffer Room for VEML7700_LOG_TIME_SIZE bytes
+ *    @returns Number of bytes encoded
+ */
+uint8_t veml7700_log_time(uint32_t time, uint8_t *buffer) {
+  buffer[0] = VEML7700_LOG_TIME;
+  for (uint8_t i = 0; i < 4; i++)
+    buffer[1 + i] = time >> (8 * i);
+  return VEML7700_LOG_TIME_SIZE;
+}
+
+/*!
+ *    @brief  Encode a reading record
+ *    @param  record The reading
+ *    @param  previous Time of the previous record in ms
+ *    @param  buffer Room for VEML7700_LOG_RECORD_MAX bytes
+ *    @returns Number of bytes encoded
+ */
+uint8_t veml7700_log_encode(const veml7700_log_record_t *record,
+                            uint32_t previous, uint8_t *buffer) {
+  uint8_t n = 0;
+  buffer[n++] = (record->gain & 0x03) |
+                ((record->integrationTime & 0x0F) << 2) |
+                (record->corrected ? VEML7700_LOG_CORRECTED : 0);
+
+  uint32_t delta = record->timestamp - previous;
+  while (delta >= 0x80) {
+    buffer[n++] = (delta & 0x7F) | 0x80;
+    delta >>= 7;
+  }
+  buffer[n++] = delta;
+
+  buffer[n++] = record->als;
+  buffer[n++] = record->als >> 8;
+  buffer[n++] = record->white;
+  buffer[n++] = record->white >> 8;
+  return n;
+}
+
+/*!
+ *    @brief  Convert a logged reading to lux with the same math as the
+ * driver
+ *    @param  record The reading
+ *    @returns Lux
+ */
+float veml7700_log_lux(const veml7700_log_record_t *record) {
+  return veml7700_raw_to_lux(record->als, record->gain,
+                             record->integrationTime, record->corrected);
+}
+
+/*!
+ *    @brief  Instantiates a reader over a log in memory
+ *    @param  data Start of the log, or of any record in it
+ *    @param  length Bytes in the log
+ *    @param  time Time of the record before data, for starting mid log
+ */
+Adafruit_VEML7700_LogReader::Adafruit_VEML7700_LogReader(const uint8_t *data,
+                                                         size_t length,
+                                                         uint32_t time)
+    : _data(data), _length(data ? length : 0), _offset(0), _time(time),
+      _error(false) {
+  if ((_length >= VEML7700_LOG_HEADER_SIZE) && (_data[0] == 'V') &&
+      (_data[1] == 'E') && (_data[2] == 'M') && (_data[3] == 'L')) {
+    if (_data[4] == VEML7700_LOG_VERSION)
+      _offset = VEML7700_LOG_HEADER_SIZE;
+    else
+      _error = true;
+  }
+}
+
+/*!
+ *    @brief  Decode the next reading record, applying any time records
+ * before it
+ *    @param  record Pointer to the structure to fill in
+ *    @returns True if a reading was decoded, false at the end of the log or
+ * on a malformed record
+ */
+bool Adafruit_VEML7700_LogReader::next(veml7700_log_record_t *record) {
+  while (!_error && (_offset < _length)) {
+    const uint8_t *p = _data + _offset;
+    size_t left = _length - _offset;
+
+    if (p[0] == VEML7700_LOG_TIME) {
+      if (left < VEML7700_LOG_TIME_SIZE)
+        break; // truncated
+      _time = (uint32_t)p[1] | ((uint32_t)p[2] << 8) | ((uint32_t)p[3] << 16) |
+              ((uint32_t)p[4] << 24);
+      _offset += VEML7700_LOG_TIME_SIZE;
+      continue;
+    }
+
+    if (p[0] & 0x80) {
+      _error = true;
+      break;
+    }
+
+    size_t n = 1;
+    uint32_t delta = 0;
+    uint8_t shift = 0;
+    do {
+      if ((n >= left) || (shift > 28)) {
+        _error = (shift > 28);
+        return false; // truncated or overlong
+      }
+      delta |= (uint32_t)(p[n] & 0x7F) << shift;
+      shift += 7;
+    } while (p[n++] & 0x80);
+
+    if (left < n + 4)
+      return false; // truncated
+
+    _time += delta;
+    record->timestamp = _time;
+    record->gain = p[0] & 0x03;
+    record->integrationTime = (p[0] >> 2) & 0x0F;
+    record->corrected = p[0] & VEML7700_LOG_CORRECTED;
+    record->als = p[n] | (p[n + 1] << 8);
+    record->white = p[n + 2] | (p[n + 3] << 8);
+    _offset += n + 4;
+    return true;
+  }
+  return false;
+}
+
+#if defined(ARDUINO)
+
+/*!
+ *    @brief  Instantiates a writer
+ *    @param  out Where to write, such as an open SD card File
+ */
+Adafruit_VEML7700_LogWriter::Adafruit_VEML7700_LogWriter(Print *out)
+    : _out(out), _time(0), _bytes(0), _synced(false) {}
+
+/*!
+ *    @brief  Start a writing session. Calling this is optional when
+ * appending to an existing log.
+ *    @param  header True to write the file header, for a new empty file
+ *    @returns True on success
+ */
+bool Adafruit_VEML7700_LogWriter::begin(bool header) {
+  uint8_t buffer[VEML7700_LOG_HEADER_SIZE];
+
+  _bytes = 0;
+  _synced = false;
+  if (!_out)
+    return false;
+  if (header)
+    return put(buffer, veml7700_log_header(buffer));
+  return true;
+}
+
+/*!
+ *    @brief  Append a reading. The first reading of a session is preceded
+ * by a time record.
+ *    @param  reading The reading to append
+ *    @returns True on success
+ */
+bool Adafruit_VEML7700_LogWriter::write(const veml7700_reading_t *reading) {
+  uint8_t buffer[VEML7700_LOG_TIME_SIZE + VEML7700_LOG_RECORD_MAX];
+  uint8_t n = 0;
+
+  if (!_out || !reading)
+    return false;
+
+  if (!_synced) {
+    n = veml7700_log_time(reading->timestamp, buffer);
+    _time = reading->timestamp;
+    _synced = true;
+  }
+
+  veml7700_log_record_t record;
+  record.timestamp = reading->timestamp;
+  record.als = reading->als;
+  record.white = reading->white;
+  record.gain = reading->gain;
+  record.integrationTime = reading->integrationTime;
+  record.corrected = reading->corrected;
+  n += veml7700_log_encode(&record, _time, buffer + n);
+  _time = reading->timestamp;
+
+  return put(buffer, n);
+}
+
+/*!
+ *    @brief  Write bytes, counting them
+ *    @param  buffer Bytes to write
+ *    @param  length Number of bytes
+ *    @returns True if all bytes were written
+ */
+bool Adafruit_VEML7700_LogWriter::put(const uint8_t *buffer, uint8_t length) {
+  size_t written = _out->write(buffer, length);
+  _bytes += written;
+  return written == length;
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*!
+ *  @file Adafruit_VEML7700_Log.h
+ *
+ * 	Compact append-only binary log of raw VEML7700 readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_LOG_H
+#define _ADAFRUIT_VEML7700_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Adafruit_VEML7700_Lux.h"
+
+/*
+ * Format, all multi-byte values little endian:
+ *
+ *   header  'V' 'E' 'M' 'L' version 0 0 0       start of a file, optional
+ *   time    0xFF t0 t1 t2 t3                    absolute time in ms
+ *   reading config delta als0 als1 white0 white1
+ *
+ * config packs the settings of a reading: bits 0-1 gain code, bits 2-5
+ * integration time code, bit 6 set if lux was corrected, bit 7 clear. delta
+ * is the time in ms since the previous record as a little endian base 128
+ * varint, 1 byte below 128ms and 2 bytes below 16s. A typical reading takes
+ * 6 or 7 bytes. Each writer session starts with a time record, so sessions
+ * can be appended to the same file.
+ */
+
+#define VEML7700_LOG_VERSION 1      ///< Format version in the header
+#define VEML7700_LOG_HEADER_SIZE 8  ///< Bytes in the file header
+#define VEML7700_LOG_TIME 0xFF      ///< First byte of a time record
+#define VEML7700_LOG_TIME_SIZE 5    ///< Bytes in a time record
+#define VEML7700_LOG_RECORD_MAX 10  ///< Most bytes in a reading record
+#define VEML7700_LOG_CORRECTED 0x40 ///< Config bit for corrected lux
+
+/** One decoded reading record */
+typedef struct {
+  uint32_t timestamp;      ///< Time in ms
+  uint16_t als;            ///< Raw ALS channel count
+  uint16_t white;          ///< Raw WHITE channel count
+  uint8_t gain;            ///< Gain setting, one of VEML7700_GAIN_*
+  uint8_t integrationTime; ///< Integration time setting, one of VEML7700_IT_*
+  bool corrected;          ///< True if lux should be corrected
+} veml7700_log_record_t;
+
+uint8_t veml7700_log_header(uint8_t *buffer);
+uint8_t veml7700_log_time(uint32_t time, uint8_t *buffer);
+uint8_t veml7700_log_encode(const veml7700_log_record_t *record,
+                            uint32_t previous, uint8_t *buffer);
+float veml7700_log_lux(const veml7700_log_record_t *record);
+
+/*!
+ *    @brief  Decodes reading records from a log held in memory. Does not
+ *            copy or modify the log, so it can run over a memory mapped
+ *            file.
+ */
+class Adafruit_VEML7700_LogReader {
+public:
+  Adafruit_VEML7700_LogReader(const uint8_t *data, size_t length,
+                              uint32_t time = 0);
+
+  bool next(veml7700_log_record_t *record);
+
+  /*! @returns True if decoding stopped on a malformed record */
+  bool error(void) const { return _error; }
+  /*! @returns Offset of the next record in the log */
+  size_t offset(void) const { return _offset; }
+  /*! @returns Time of the last record decoded */
+  uint32_t time(void) const { return _time; }
+
+private:
+  const uint8_t *_data;
+  size_t _length, _offset;
+  uint32_t _time;
+  bool _error;
+};
+
+#if defined(ARDUINO)
+#include "Adafruit_VEML7700.h"
+
+/*!
+ *    @brief  Appends readings in the binary log format to any Arduino Print,
+ *            such as an SD card File or a flash file system file
+ */
+class Adafruit_VEML7700_LogWriter {
+public:
+  Adafruit_VEML7700_LogWriter(Print *out);
+
+  bool begin(bool header = true);
+  bool write(const veml7700_reading_t *reading);
+
+  /*! @returns Bytes written since begin() */
+  uint32_t bytesWritten(void) const { return _bytes; }
+
+private:
+  bool put(const uint8_t *buffer, uint8_t length);
+
+  Print *_out;
+  uint32_t _time, _bytes;
+  bool _synced; // a time record has been written this session
+};
+#endif
+
+#endif
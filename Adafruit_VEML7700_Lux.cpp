@@ -0,0 +1,239 @@
+/*!
+ *  @file Adafruit_VEML7700_Lux.cpp
+ *
+ * 	Lux conversion math for the VEML7700
+ *
+ * 	This has no Arduino or bus dependencies, so host tools that reprocess
+ * 	logged counts build it unchanged and get the same results as the
+ * 	driver.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Lux.h"
+
+// Fusing multiplies and adds would round differently on parts with FMA, and
+// host tools are expected to match the device bit for bit.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// lets the compiler vectorize the array loops without alias checks
+#if defined(__GNUC__)
+#define VEML7700_RESTRICT __restrict__
+#else
+#define VEML7700_RESTRICT
+#endif
+
+static const float MAX_RES = 0.0036; // lux per count at gain 2, 800ms
+static const float GAIN_MAX = 2;
+static const float IT_MAX = 800;
+
+/*!
+ *    @brief Convert a gain setting to its actual gain
+ *    @param gain Gain setting, one of VEML7700_GAIN_*
+ *    @returns Actual gain value as float, or -1 for an invalid setting
+ */
+float veml7700_gain_value(uint8_t gain) {
+  switch (gain) {
+  case VEML7700_GAIN_1_8:
+    return 0.125;
+  case VEML7700_GAIN_1_4:
+    return 0.25;
+  case VEML7700_GAIN_1:
+    return 1;
+  case VEML7700_GAIN_2:
+    return 2;
+  default:
+    return -1;
+  }
+}
+
+/*!
+ *    @brief Convert an integration time setting to milliseconds
+ *    @param it Integration time setting, one of VEML7700_IT_*
+ *    @returns Integration time in milliseconds, or -1 for an invalid setting
+ */
+int veml7700_integration_time_value(uint8_t it) {
+  switch (it) {
+  case VEML7700_IT_25MS:
+    return 25;
+  case VEML7700_IT_50MS:
+    return 50;
+  case VEML7700_IT_100MS:
+    return 100;
+  case VEML7700_IT_200MS:
+    return 200;
+  case VEML7700_IT_400MS:
+    return 400;
+  case VEML7700_IT_800MS:
+    return 800;
+  default:
+    return -1;
+  }
+}
+
+/*!
+ *    @brief Determines resolution for the given gain and integration time
+ * settings
+ *    @param gain Gain setting, one of VEML7700_GAIN_*
+ *    @param it Integration time setting, one of VEML7700_IT_*
+ *    @returns Lux per count
+ */
+float veml7700_resolution(uint8_t gain, uint8_t it) {
+  return MAX_RES * (IT_MAX / veml7700_integration_time_value(it)) *
+         (GAIN_MAX / veml7700_gain_value(gain));
+}
+
+/*!
+ *    @brief Apply the App Note non-linear correction to a linear lux value
+ *    @param lux Linear lux value
+ *    @returns Corrected lux value
+ */
+float veml7700_correct_lux(float lux) {
+  // float constants so every platform rounds the same way, including AVR
+  // where double is float
+  return (((6.0135e-13f * lux - 9.3924e-9f) * lux + 8.1488e-5f) * lux +
+          1.0023f) *
+         lux;
+}
+
+/*!
+ *    @brief Compute lux from a raw ALS count taken at known settings
+ *    @param rawALS raw ALS register value
+ *    @param gain Gain setting the count was taken with
+ *    @param it Integration time setting the count was taken with
+ *    @param corrected if true, apply non-linear correction
+ *    @return lux value
+ */
+float veml7700_raw_to_lux(uint16_t rawALS, uint8_t gain, uint8_t it,
+                          bool corrected) {
+  float lux = veml7700_resolution(gain, it) * rawALS;
+  if (corrected)
+    lux = veml7700_correct_lux(lux);
+  return lux;
+}
+
+/*!
+ *    @brief Integer only version of veml7700_raw_to_lux() without the
+ * non-linear correction, for parts without an FPU. Every resolution is 0.0036
+ * lux per count times a power of two, so this is a multiply and a shift.
+ *    @param rawALS raw ALS register value
+ *    @param gain Gain setting the count was taken with
+ *    @param it Integration time setting the count was taken with
+ *    @return lux value in thousandths of a lux, rounded, or 0 for an invalid
+ * setting
+ */
+uint32_t veml7700_raw_to_millilux(uint16_t rawALS, uint8_t gain,
+                                  uint8_t it) {
+  uint8_t shift;
+
+  switch (gain) {
+  case VEML7700_GAIN_2:
+    shift = 0;
+    break;
+  case VEML7700_GAIN_1:
+    shift = 1;
+    break;
+  case VEML7700_GAIN_1_4:
+    shift = 3;
+    break;
+  case VEML7700_GAIN_1_8:
+    shift = 4;
+    break;
+  default:
+    return 0;
+  }
+
+  switch (it) {
+  case VEML7700_IT_800MS:
+    break;
+  case VEML7700_IT_400MS:
+    shift += 1;
+    break;
+  case VEML7700_IT_200MS:
+    shift += 2;
+    break;
+  case VEML7700_IT_100MS:
+    shift += 3;
+    break;
+  case VEML7700_IT_50MS:
+    shift += 4;
+    break;
+  case VEML7700_IT_25MS:
+    shift += 5;
+    break;
+  default:
+    return 0;
+  }
+
+  // MAX_RES is 3.6 mlux, at most 65535 * 36 << 9 which fits in 32 bits
+  return (((uint32_t)rawALS * 36 << shift) + 5) / 10;
+}
+
+/*!
+ *    @brief Compute lux for an array of raw ALS counts all taken at the same
+ * settings. Results match veml7700_raw_to_lux() bit for bit. The loops are
+ * kept simple so host compilers vectorize them, build with -O3 (or -O2
+ * -ftree-vectorize) to get SIMD code.
+ *    @param rawALS raw ALS register values
+ *    @param lux Output lux values, must not overlap rawALS
+ *    @param count Number of values
+ *    @param gain Gain setting the counts were taken with
+ *    @param it Integration time setting the counts were taken with
+ *    @param corrected if true, apply non-linear correction
+ */
+void veml7700_raw_to_lux_array(const uint16_t *VEML7700_RESTRICT rawALS,
+                               float *VEML7700_RESTRICT lux, size_t count,
+                               uint8_t gain, uint8_t it, bool corrected) {
+  const float resolution = veml7700_resolution(gain, it);
+
+  for (size_t i = 0; i < count; i++)
+    lux[i] = resolution * rawALS[i];
+
+  if (corrected) {
+    for (size_t i = 0; i < count; i++)
+      lux[i] = veml7700_correct_lux(lux[i]);
+  }
+}
+
+/*!
+ *    @brief Compute lux for an array of raw ALS counts, each with its own
+ * settings, such as a decoded log. Results match veml7700_raw_to_lux() bit
+ * for bit for valid settings.
+ *    @param rawALS raw ALS register values
+ *    @param gain Gain setting of each count
+ *    @param it Integration time setting of each count
+ *    @param lux Output lux values, must not overlap the inputs. Counts with
+ * an invalid setting give 0.
+ *    @param count Number of values
+ *    @param corrected if true, apply non-linear correction
+ */
+void veml7700_raw_to_lux_mixed(const uint16_t *VEML7700_RESTRICT rawALS,
+                               const uint8_t *VEML7700_RESTRICT gain,
+                               const uint8_t *VEML7700_RESTRICT it,
+                               float *VEML7700_RESTRICT lux, size_t count,
+                               bool corrected) {
+  // Each count is scaled by MAX_RES times 2 to the number of gain and
+  // integration time steps below the maximum. The steps are worked out with
+  // bit arithmetic rather than tables or branches so the loop vectorizes.
+  for (size_t i = 0; i < count; i++) {
+    int g = gain[i];
+    int t = it[i];
+    int hi = t >> 2;
+    int valid = (g <= 0x03) & ((t <= 0x03) | (t == 0x08) | (t == 0x0C));
+    // gain 1, 2, 1/8, 1/4 are 1, 0, 4, 3 steps down
+    int shift = (g ^ 1) + (g >> 1);
+    // 100, 200, 400, 800ms are 3 to 0 steps, 50 and 25ms are 4 and 5
+    shift += 3 - (t & 0x03) + hi - (hi != 0);
+    float value = MAX_RES * (float)(1 << (shift & 0x0F)) * rawALS[i];
+    lux[i] = value * valid;
+  }
+
+  if (corrected) {
+    for (size_t i = 0; i < count; i++)
+      lux[i] = veml7700_correct_lux(lux[i]);
+  }
+}
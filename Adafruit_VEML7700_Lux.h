@@ -0,0 +1,70 @@
+/*!
+ *  @file Adafruit_VEML7700_Lux.h
+ *
+ * 	Lux conversion math for the VEML7700, free of Arduino and bus
+ * 	dependencies
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_LUX_H
+#define _ADAFRUIT_VEML7700_LUX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VEML7700_GAIN_1 0x00   ///< ALS gain 1x
+#define VEML7700_GAIN_2 0x01   ///< ALS gain 2x
+#define VEML7700_GAIN_1_8 0x02 ///< ALS gain 1/8x
+#define VEML7700_GAIN_1_4 0x03 ///< ALS gain 1/4x
+
+#define VEML7700_IT_100MS 0x00 ///< ALS intetgration time 100ms
+#define VEML7700_IT_200MS 0x01 ///< ALS intetgration time 200ms
+#define VEML7700_IT_400MS 0x02 ///< ALS intetgration time 400ms
+#define VEML7700_IT_800MS 0x03 ///< ALS intetgration time 800ms
+#define VEML7700_IT_50MS 0x08  ///< ALS intetgration time 50ms
+#define VEML7700_IT_25MS 0x0C  ///< ALS intetgration time 25ms
+
+/** Options for lux reading method */
+typedef enum {
+  VEML_LUX_NORMAL,
+  VEML_LUX_CORRECTED,
+  VEML_LUX_AUTO,
+  VEML_LUX_NORMAL_NOWAIT,
+  VEML_LUX_CORRECTED_NOWAIT
+} luxMethod;
+
+/** A single timestamped reading along with the settings used to take it */
+typedef struct {
+  uint32_t timestamp;      ///< millis() at which the ALS data was read
+  uint16_t als;            ///< Raw ALS channel count
+  uint16_t white;          ///< Raw WHITE channel count
+  uint8_t gain;            ///< Gain setting, one of VEML7700_GAIN_*
+  uint8_t integrationTime; ///< Integration time setting, one of VEML7700_IT_*
+  bool corrected;          ///< True if lux has the non-linear correction
+  float lux;               ///< Lux computed from the ALS count
+} veml7700_reading_t;
+
+float veml7700_gain_value(uint8_t gain);
+int veml7700_integration_time_value(uint8_t it);
+float veml7700_resolution(uint8_t gain, uint8_t it);
+float veml7700_correct_lux(float lux);
+float veml7700_raw_to_lux(uint16_t rawALS, uint8_t gain, uint8_t it,
+                          bool corrected = false);
+uint32_t veml7700_raw_to_millilux(uint16_t rawALS, uint8_t gain, uint8_t it);
+void veml7700_raw_to_lux_array(const uint16_t *rawALS, float *lux,
+                               size_t count, uint8_t gain, uint8_t it,
+                               bool corrected = false);
+void veml7700_raw_to_lux_mixed(const uint16_t *rawALS, const uint8_t *gain,
+                               const uint8_t *it, float *lux, size_t count,
+                               bool corrected = false);
+
+#endif
@@ -0,0 +1,146 @@
+/*!
+ *  @file Adafruit_VEML7700_LuxCode.cpp
+ *
+ * 	Logarithmic 16 and 8 bit encodings of lux
+ *
+ * 	Encoding and decoding split the float into its exponent, which is the
+ * 	whole octave, and mantissa. The fraction of an octave comes from a 65
+ * 	entry table with linear interpolation in between, good to about a
+ * 	tenth of a 16 bit code, so every code decodes and encodes back to
+ * 	itself. No libm calls are needed.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_LuxCode.h"
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define TABLE_READ(table, i) pgm_read_word(&(table)[i])
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define TABLE_READ(table, i) ((table)[i])
+#endif
+
+// round(32768 * log2(1 + k / 64))
+static const uint16_t log2Table[65] PROGMEM = {
+    0,     733,   1455,  2166,  2866,  3556,  4236,  4907,  5568,  6220,
+    6863,  7498,  8124,  8742,  9352,  9954,  10549, 11136, 11716, 12289,
+    12855, 13415, 13968, 14514, 15055, 15589, 16117, 16639, 17156, 17667,
+    18173, 18673, 19168, 19658, 20143, 20623, 21098, 21568, 22034, 22495,
+    22952, 23404, 23852, 24296, 24736, 25172, 25604, 26031, 26455, 26876,
+    27292, 27705, 28114, 28520, 28922, 29321, 29717, 30109, 30498, 30884,
+    31267, 31647, 32024, 32397, 32768};
+
+// round(32768 * (2^(k / 64) - 1))
+static const uint16_t exp2Table[65] PROGMEM = {
+    0,     357,   718,   1082,  1451,  1823,  2200,  2581,  2966,  3355,
+    3748,  4146,  4548,  4954,  5365,  5780,  6200,  6624,  7053,  7487,
+    7925,  8368,  8816,  9269,  9727,  10190, 10657, 11130, 11608, 12091,
+    12580, 13074, 13573, 14078, 14588, 15103, 15625, 16152, 16684, 17223,
+    17767, 18317, 18874, 19436, 20005, 20579, 21160, 21747, 22341, 22941,
+    23548, 24161, 24781, 25408, 26041, 26681, 27329, 27983, 28645, 29313,
+    29989, 30673, 31364, 32062, 32768};
+
+/*!
+ *    @brief Encode lux as a 16 bit logarithmic code
+ *    @param lux Lux value
+ *    @returns Code, 0 for zero, negative or NaN lux
+ */
+uint16_t veml7700_lux_to_code16(float lux) {
+  if (!(lux > 0))
+    return 0;
+
+  uint32_t bits;
+  memcpy(&bits, &lux, sizeof(bits));
+  int16_t octave = (int16_t)(bits >> 23) - 127 + VEML7700_LUXCODE_OFFSET;
+  if (octave < 0)
+    return 1;
+  if (octave >= 32)
+    return 0xFFFF;
+
+  // log2 of the mantissa in 1/32768 octave, from the top 6 bits and
+  // interpolation over the remaining 17
+  uint8_t i = (bits >> 17) & 0x3F;
+  uint32_t rest = bits & 0x1FFFF;
+  uint16_t low = TABLE_READ(log2Table, i);
+  uint16_t high = TABLE_READ(log2Table, i + 1);
+  uint16_t fraction = low + (((uint32_t)(high - low) * rest) >> 17);
+
+  uint32_t code = ((uint32_t)octave << VEML7700_LUXCODE16_STEPS) +
+                  ((fraction + 8) >> (15 - VEML7700_LUXCODE16_STEPS));
+  if (code < 1)
+    return 1;
+  if (code > 0xFFFF)
+    return 0xFFFF;
+  return code;
+}
+
+/*!
+ *    @brief Decode a 16 bit logarithmic code to lux
+ *    @param code Code from veml7700_lux_to_code16()
+ *    @returns Lux value
+ */
+float veml7700_code16_to_lux(uint16_t code) {
+  if (code == 0)
+    return 0;
+
+  uint8_t octave = code >> VEML7700_LUXCODE16_STEPS;
+  uint16_t fraction = code & ((1 << VEML7700_LUXCODE16_STEPS) - 1);
+
+  // 2^fraction in 1/32768, from the top 6 bits and interpolation over the
+  // remaining 5
+  uint8_t i = fraction >> 5;
+  uint8_t rest = fraction & 0x1F;
+  uint16_t low = TABLE_READ(exp2Table, i);
+  uint16_t high = TABLE_READ(exp2Table, i + 1);
+  uint32_t mantissa = low + (((uint32_t)(high - low) * rest + 16) >> 5);
+
+  // built directly as the bits of a float, mantissa 32768 rolls over into
+  // the next exponent
+  uint32_t bits =
+      ((uint32_t)(octave + 127 - VEML7700_LUXCODE_OFFSET) << 23) +
+      (mantissa << 8);
+  float lux;
+  memcpy(&lux, &bits, sizeof(lux));
+  return lux;
+}
+
+/*!
+ *    @brief Round a 16 bit logarithmic code to an 8 bit one
+ *    @param code Code from veml7700_lux_to_code16()
+ *    @returns 8 bit code
+ */
+uint8_t veml7700_code16_to_code8(uint16_t code) {
+  if (code == 0)
+    return 0;
+  uint16_t shift = VEML7700_LUXCODE16_STEPS - VEML7700_LUXCODE8_STEPS;
+  uint32_t rounded = ((uint32_t)code + (1 << (shift - 1))) >> shift;
+  if (rounded < 1)
+    return 1;
+  if (rounded > 0xFF)
+    return 0xFF;
+  return rounded;
+}
+
+/*!
+ *    @brief Encode lux as an 8 bit logarithmic code
+ *    @param lux Lux value
+ *    @returns Code, 0 for zero, negative or NaN lux
+ */
+uint8_t veml7700_lux_to_code8(float lux) {
+  return veml7700_code16_to_code8(veml7700_lux_to_code16(lux));
+}
+
+/*!
+ *    @brief Decode an 8 bit logarithmic code to lux
+ *    @param code Code from veml7700_lux_to_code8()
+ *    @returns Lux value
+ */
+float veml7700_code8_to_lux(uint8_t code) {
+  return veml7700_code16_to_lux(
+      (uint16_t)code << (VEML7700_LUXCODE16_STEPS - VEML7700_LUXCODE8_STEPS));
+}
@@ -0,0 +1,51 @@
+/*!
+ *  @file Adafruit_VEML7700_LuxCode.h
+ *
+ * 	Logarithmic 16 and 8 bit encodings of lux for compact storage and
+ * 	transport
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_LUXCODE_H
+#define _ADAFRUIT_VEML7700_LUXCODE_H
+
+#include <stdint.h>
+
+/*
+ * Both encodings cover 32 octaves, 2^-9 (0.00195) to 2^23 (8.4M) lux,
+ * which spans every uncorrected and corrected lux the sensor can report.
+ * Code 0 is 0 lux, and values outside the range clamp to the end codes.
+ * The table driven log2 lands on the nearest code except within about a
+ * tenth of a code of a rounding boundary.
+ *
+ *   16 bit  code = round(2048 * (log2(lux) + 9))   2048 codes per octave
+ *                  relative error within +-0.025%
+ *    8 bit  code = round(8 * (log2(lux) + 9))      8 codes per octave
+ *                  relative error within +-4.5%
+ *
+ * The 8 bit code is the 16 bit code rounded to its top byte, so it can be
+ * made from a stored 16 bit code without decoding. Codes sort in lux order
+ * and equal ratios of lux give equal differences of code, which suits
+ * comparing and thresholding values without decoding them.
+ */
+
+#define VEML7700_LUXCODE_OFFSET 9   ///< Octaves below 1 lux covered
+#define VEML7700_LUXCODE16_STEPS 11 ///< log2 of 16 bit codes per octave
+#define VEML7700_LUXCODE8_STEPS 3   ///< log2 of 8 bit codes per octave
+
+uint16_t veml7700_lux_to_code16(float lux);
+float veml7700_code16_to_lux(uint16_t code);
+uint8_t veml7700_code16_to_code8(uint16_t code);
+uint8_t veml7700_lux_to_code8(float lux);
+float veml7700_code8_to_lux(uint8_t code);
+
+#endif
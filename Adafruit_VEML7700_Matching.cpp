@@ -0,0 +1,152 @@
+/*!
+ *  @file Adafruit_VEML7700_Matching.cpp
+ *
+ * 	Gain matching across an array of VEML7700s from co-located exposures
+ *
+ * 	Free of Arduino dependencies, so it runs against the simulator on a
+ * 	host as well as on a board.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Matching.h"
+#include <math.h>
+
+/*!
+ *    @brief  Instantiates a solver
+ *    @param  sums Storage for one float per sensor
+ *    @param  sensors Number of sensors in the array
+ */
+Adafruit_VEML7700_Matching::Adafruit_VEML7700_Matching(float *sums,
+                                                       uint8_t sensors)
+    : _sums(sums), _sensors(sensors), _reference(VEML7700_MATCHING_NONE) {
+  reset();
+}
+
+/*!
+ *    @brief  Choose a sensor whose response the others are matched to, such
+ * as one calibrated against a lux meter
+ *    @param  sensor Index of the sensor, or VEML7700_MATCHING_NONE for
+ * scales that multiply to 1
+ */
+void Adafruit_VEML7700_Matching::setReference(uint8_t sensor) {
+  _reference = (sensor < _sensors) ? sensor : VEML7700_MATCHING_NONE;
+}
+
+/*!
+ *    @brief  Forget all exposures
+ */
+void Adafruit_VEML7700_Matching::reset(void) {
+  for (uint8_t i = 0; i < _sensors; i++)
+    _sums[i] = 0;
+  _squares = 0;
+  _exposures = 0;
+}
+
+/*!
+ *    @brief  Add an exposure of raw counts, all taken at the same gain and
+ * integration time. The scales found are relative to a nominal part.
+ *    @param  als Raw ALS count of each sensor
+ *    @returns True if the exposure was used, false if any count was too
+ * low to resolve or saturated
+ */
+bool Adafruit_VEML7700_Matching::add(const uint16_t *als) {
+  for (uint8_t i = 0; i < _sensors; i++) {
+    if ((als[i] < VEML7700_MATCHING_MIN_ALS) || (als[i] == 0xFFFF))
+      return false;
+  }
+  // only ratios matter, so counts stand in for lux
+  return accumulate(als, NULL);
+}
+
+/*!
+ *    @brief  Add an exposure of lux values, read without the non-linear
+ * correction and with a zero offset. The scales found refine the
+ * calibration the values were read with.
+ *    @param  lux Lux of each sensor
+ *    @returns True if the exposure was used, false if any value was not
+ * positive
+ */
+bool Adafruit_VEML7700_Matching::add(const float *lux) {
+  for (uint8_t i = 0; i < _sensors; i++) {
+    if (!(lux[i] > 0))
+      return false;
+  }
+  return accumulate(NULL, lux);
+}
+
+/*!
+ *    @brief  Add the log ratios of one checked exposure to the sums. The
+ * logs are taken twice rather than stored, so any array size fits in the
+ * RAM of small boards.
+ *    @param  als Raw counts, or NULL
+ *    @param  lux Lux values if als is NULL
+ *    @returns True if the exposure was used
+ */
+bool Adafruit_VEML7700_Matching::accumulate(const uint16_t *als,
+                                            const float *lux) {
+  if (!_sensors)
+    return false;
+
+  float mean = 0;
+  for (uint8_t i = 0; i < _sensors; i++)
+    mean += log(als ? (float)als[i] : lux[i]);
+  mean /= _sensors;
+
+  for (uint8_t i = 0; i < _sensors; i++) {
+    float error = mean - log(als ? (float)als[i] : lux[i]);
+    _sums[i] += error;
+    _squares += error * error;
+  }
+  _exposures++;
+  return true;
+}
+
+/*!
+ *    @brief  Get the scale factor that matches a sensor to the array
+ *    @param  sensor Index of the sensor
+ *    @returns Factor to multiply the sensor's lux by, 1 before any exposure
+ */
+float Adafruit_VEML7700_Matching::scale(uint8_t sensor) const {
+  if ((sensor >= _sensors) || !_exposures)
+    return 1;
+  float logScale = _sums[sensor];
+  if (_reference != VEML7700_MATCHING_NONE)
+    logScale -= _sums[_reference];
+  return exp(logScale / _exposures);
+}
+
+/*!
+ *    @brief  How well the scales explain the exposures. Large values mean
+ * the sensors did not see the same light, or respond differently to it
+ * than by a constant factor.
+ *    @returns RMS relative disagreement left after scaling, 0 with fewer
+ * than 2 exposures
+ */
+float Adafruit_VEML7700_Matching::residual(void) const {
+  if ((_exposures < 2) || (_sensors < 2))
+    return 0;
+  // squares about each sensor's own mean, which its scale removes
+  float squares = _squares;
+  for (uint8_t i = 0; i < _sensors; i++)
+    squares -= _sums[i] * _sums[i] / _exposures;
+  // each exposure's mean uses up one degree of freedom, each scale another
+  float dof = (float)(_exposures - 1) * (_sensors - 1);
+  return squares > 0 ? sqrt(squares / dof) : 0;
+}
+
+/*!
+ *    @brief  Fold a sensor's scale into its calibration, ready for
+ * setCalibration() or veml7700_calibration_encode()
+ *    @param  sensor Index of the sensor
+ *    @param  calibration The calibration the exposures were read with,
+ * nominal for raw counts, updated in place
+ *    @returns True on success, false before any exposure
+ */
+bool Adafruit_VEML7700_Matching::apply(
+    uint8_t sensor, veml7700_calibration_t *calibration) const {
+  if ((sensor >= _sensors) || !_exposures || !calibration)
+    return false;
+  calibration->scale *= scale(sensor);
+  return true;
+}
@@ -0,0 +1,68 @@
+/*!
+ *  @file Adafruit_VEML7700_Matching.h
+ *
+ * 	Gain matching across an array of VEML7700s from co-located exposures,
+ * 	free of Arduino and bus dependencies
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_MATCHING_H
+#define _ADAFRUIT_VEML7700_MATCHING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Adafruit_VEML7700_Calibration.h"
+
+#define VEML7700_MATCHING_MIN_ALS 100 ///< Fewest counts for a usable exposure
+#define VEML7700_MATCHING_NONE 0xFF   ///< No reference sensor
+
+/*!
+ *    @brief  Solves for the scale factor of each sensor in an array that
+ *            makes them all agree, from exposures in which every sensor sees
+ *            the same light. Each sensor's scale is the geometric mean over
+ *            the exposures of the array's geometric mean count divided by
+ *            the sensor's own, the least squares fit of the log counts, so
+ *            bright and dim exposures weigh the same. The scales multiply to
+ *            1, or leave a chosen reference sensor as it is. Work per
+ *            exposure is O(sensors), in caller supplied storage of one
+ *            float per sensor.
+ */
+class Adafruit_VEML7700_Matching {
+public:
+  Adafruit_VEML7700_Matching(float *sums, uint8_t sensors);
+
+  void setReference(uint8_t sensor);
+  void reset(void);
+
+  bool add(const uint16_t *als);
+  bool add(const float *lux);
+
+  float scale(uint8_t sensor) const;
+  float residual(void) const;
+  bool apply(uint8_t sensor, veml7700_calibration_t *calibration) const;
+
+  /*! @returns Number of exposures used since reset() */
+  uint32_t exposures(void) const { return _exposures; }
+  /*! @returns Number of sensors in the array */
+  uint8_t sensors(void) const { return _sensors; }
+
+private:
+  bool accumulate(const uint16_t *als, const float *lux);
+
+  float *_sums; // per sensor sum of log(array mean / sensor)
+  float _squares;
+  uint32_t _exposures;
+  uint8_t _sensors, _reference;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*!
+ *  @file Adafruit_VEML7700_Quantile.cpp
+ *
+ * 	Streaming quantile estimation over VEML7700 readings
+ *
+ * 	Five markers track the minimum, the p/2, p and (1+p)/2 quantiles and
+ * 	the maximum. Each new value shifts the marker positions, and any middle
+ * 	marker that drifts a whole position from where it should be is moved
+ * 	one step, adjusting its height along a parabola through its
+ * 	neighbours.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Quantile.h"
+
+/*!
+ *    @brief  Instantiates an estimator
+ *    @param  p The quantile to estimate, 0 to 1. 0.5 is the median.
+ */
+Adafruit_VEML7700_Quantile::Adafruit_VEML7700_Quantile(float p) {
+  _p = (p < 0) ? 0 : ((p > 1) ? 1 : p);
+  reset();
+}
+
+/*!
+ *    @brief  Forget all values
+ */
+void Adafruit_VEML7700_Quantile::reset(void) {
+  _count = 0;
+  for (uint8_t i = 0; i < 5; i++) {
+    _height[i] = 0;
+    _pos[i] = i + 1;
+  }
+}
+
+/*!
+ *    @brief  Where marker i should be after the current count. The
+ * positions start at 1, 1+2p, 1+4p, 3+2p and 5 with five values and move
+ * by 0, p/2, p, (1+p)/2 and 1 per value after that.
+ *    @param  i Marker index
+ *    @returns Desired position
+ */
+float Adafruit_VEML7700_Quantile::desired(uint8_t i) const {
+  float extra = _count - 5;
+  switch (i) {
+  case 0:
+    return 1;
+  case 1:
+    return 1 + 2 * _p + extra * _p / 2;
+  case 2:
+    return 1 + 4 * _p + extra * _p;
+  case 3:
+    return 3 + 2 * _p + extra * (1 + _p) / 2;
+  default:
+    return _count;
+  }
+}
+
+/*!
+ *    @brief  Piecewise parabolic prediction of marker i moved by d
+ *    @param  i Marker index, 1 to 3
+ *    @param  d Direction, 1 or -1
+ *    @returns New height
+ */
+float Adafruit_VEML7700_Quantile::parabolic(uint8_t i, int8_t d) const {
+  float below = _pos[i] - _pos[i - 1];
+  float above = _pos[i + 1] - _pos[i];
+  return _height[i] +
+         d / (float)(_pos[i + 1] - _pos[i - 1]) *
+             ((below + d) * (_height[i + 1] - _height[i]) / above +
+              (above - d) * (_height[i] - _height[i - 1]) / below);
+}
+
+/*!
+ *    @brief  Linear prediction of marker i moved by d, used when the
+ * parabola would break the ordering of the markers
+ *    @param  i Marker index, 1 to 3
+ *    @param  d Direction, 1 or -1
+ *    @returns New height
+ */
+float Adafruit_VEML7700_Quantile::linear(uint8_t i, int8_t d) const {
+  return _height[i] +
+         d * (_height[i + d] - _height[i]) / (_pos[i + d] - _pos[i]);
+}
+
+/*!
+ *    @brief  Add a lux value
+ *    @param  lux The value to add
+ */
+void Adafruit_VEML7700_Quantile::add(float lux) {
+  if (_count < 5) {
+    // insertion sort the first five values into the markers
+    uint8_t i = _count++;
+    while ((i > 0) && (_height[i - 1] > lux)) {
+      _height[i] = _height[i - 1];
+      i--;
+    }
+    _height[i] = lux;
+    return;
+  }
+
+  uint8_t k;
+  if (lux < _height[0]) {
+    _height[0] = lux;
+    k = 0;
+  } else if (lux >= _height[4]) {
+    _height[4] = lux;
+    k = 3;
+  } else {
+    k = 0;
+    while (lux >= _height[k + 1])
+      k++;
+  }
+
+  for (uint8_t i = k + 1; i < 5; i++)
+    _pos[i]++;
+  _count++;
+
+  for (uint8_t i = 1; i < 4; i++) {
+    float drift = desired(i) - _pos[i];
+    if (((drift >= 1) && (_pos[i + 1] - _pos[i] > 1)) ||
+        ((drift <= -1) && (_pos[i - 1] - _pos[i] < -1))) {
+      int8_t d = (drift > 0) ? 1 : -1;
+      float height = parabolic(i, d);
+      if ((_height[i - 1] < height) && (height < _height[i + 1]))
+        _height[i] = height;
+      else
+        _height[i] = linear(i, d);
+      _pos[i] += d;
+    }
+  }
+}
+
+/*!
+ *    @brief  Add the lux of a reading
+ *    @param  reading The reading to add
+ */
+void Adafruit_VEML7700_Quantile::add(const veml7700_reading_t *reading) {
+  if (reading)
+    add(reading->lux);
+}
+
+/*!
+ *    @brief  Get the current estimate
+ *    @returns Estimated quantile in lux, exact while fewer than five values
+ * have been added, 0 if none have
+ */
+float Adafruit_VEML7700_Quantile::estimate(void) const {
+  if (_count == 0)
+    return 0;
+  if (_count < 5)
+    return _height[(uint8_t)(_p * (_count - 1) + 0.5)];
+  return _height[2];
+}
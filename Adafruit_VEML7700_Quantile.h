@@ -0,0 +1,53 @@
+/*!
+ *  @file Adafruit_VEML7700_Quantile.h
+ *
+ * 	Streaming quantile estimation over VEML7700 readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_QUANTILE_H
+#define _ADAFRUIT_VEML7700_QUANTILE_H
+
+#include "Adafruit_VEML7700.h"
+
+/*!
+ *    @brief  Estimates one quantile of a stream of lux values in constant
+ *            memory (about 50 bytes) with the P-squared algorithm of Jain and
+ *            Chlamtac, without storing the values. Use one instance per
+ *            quantile, for example three for P10, P50 and P90.
+ */
+class Adafruit_VEML7700_Quantile {
+public:
+  Adafruit_VEML7700_Quantile(float p = 0.5);
+
+  void reset(void);
+  void add(float lux);
+  void add(const veml7700_reading_t *reading);
+  float estimate(void) const;
+
+  /*! @returns The quantile being estimated, 0 to 1 */
+  float quantile(void) const { return _p; }
+  /*! @returns Number of values added since reset() */
+  uint32_t count(void) const { return _count; }
+
+private:
+  float desired(uint8_t i) const;
+  float parabolic(uint8_t i, int8_t d) const;
+  float linear(uint8_t i, int8_t d) const;
+
+  float _p;
+  uint32_t _count;
+  float _height[5]; // marker heights
+  int32_t _pos[5];  // marker positions, 1 based
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*!
+ *  @file Adafruit_VEML7700_Sampler.cpp
+ *
+ * 	Adaptive rate sampling for the VEML7700
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Sampler.h"
+
+/*!
+ *    @brief  Instantiates a sampler for a sensor that has been begin()'d
+ *    @param  sensor The sensor to read
+ *    @param  minInterval Interval used while the light is changing, in ms
+ *    @param  maxInterval Longest interval used while the light is stable,
+ * in ms
+ */
+Adafruit_VEML7700_Sampler::Adafruit_VEML7700_Sampler(Adafruit_VEML7700 *sensor,
+                                                     uint32_t minInterval,
+                                                     uint32_t maxInterval)
+    : _sensor(sensor), _method(VEML_LUX_NORMAL), _relative(0.05),
+      _absolute(0.5), _powerSave(false), _poweredDown(false),
+      _powerSaveMode(VEML7700_POWERSAVE_MODE4) {
+  setIntervals(minInterval, maxInterval);
+  reset();
+}
+
+/*!
+ *    @brief  Set the bounds of the sampling interval
+ *    @param  minInterval Interval used while the light is changing, in ms
+ *    @param  maxInterval Longest interval used while the light is stable,
+ * in ms
+ */
+void Adafruit_VEML7700_Sampler::setIntervals(uint32_t minInterval,
+                                             uint32_t maxInterval) {
+  _minInterval = minInterval ? minInterval : 1;
+  _maxInterval = maxInterval > _minInterval ? maxInterval : _minInterval;
+  _interval = _minInterval;
+}
+
+/*!
+ *    @brief  Set how large a change counts as significant. A change must
+ * exceed both limits.
+ *    @param  relative Fraction of the previous reading, default 0.05
+ *    @param  absolute Lux, default 0.5, keeps noise in the dark from
+ * counting
+ */
+void Adafruit_VEML7700_Sampler::setThreshold(float relative, float absolute) {
+  _relative = relative;
+  _absolute = absolute;
+}
+
+/*!
+ *    @brief  Set the lux computation method used for readings
+ *    @param  method One of the luxMethod values, default VEML_LUX_NORMAL
+ */
+void Adafruit_VEML7700_Sampler::setMethod(luxMethod method) {
+  _method = method;
+}
+
+/*!
+ *    @brief  Allow the sensor to be put in power save mode while the
+ * interval is at its maximum
+ *    @param  enable True to allow power save mode
+ *    @param  mode Power save mode to use, one of VEML7700_POWERSAVE_MODE*
+ */
+void Adafruit_VEML7700_Sampler::setPowerSave(bool enable, uint8_t mode) {
+  _powerSave = enable;
+  _powerSaveMode = mode;
+  if (!enable)
+    powerDown(false);
+}
+
+/*!
+ *    @brief  Forget the previous reading and go back to the minimum
+ * interval. The next update() takes a reading right away.
+ */
+void Adafruit_VEML7700_Sampler::reset(void) {
+  memset(&_last, 0, sizeof(_last));
+  _interval = _minInterval;
+  _lastSample = 0;
+  _primed = false;
+  powerDown(false);
+}
+
+/*!
+ *    @brief  Check whether a lux value differs significantly from the
+ * previous reading
+ *    @param  lux The lux value to compare
+ *    @returns True if the change exceeds the threshold
+ */
+bool Adafruit_VEML7700_Sampler::changed(float lux) const {
+  float delta = fabs(lux - _last.lux);
+  return (delta > _absolute) && (delta > _relative * fabs(_last.lux));
+}
+
+/*!
+ *    @brief  Call this often, from loop(). Takes a reading when the current
+ * interval has passed and adjusts the interval.
+ *    @param  reading Optional pointer to receive the new reading
+ *    @returns True if a reading was taken
+ */
+bool Adafruit_VEML7700_Sampler::update(veml7700_reading_t *reading) {
+  unsigned long now = millis();
+  if (_primed && (now - _lastSample < _interval))
+    return false;
+
+  veml7700_reading_t current;
+  if (!_sensor || !_sensor->getReading(&current, _method))
+    return false;
+  _lastSample = now;
+
+  if (!_primed || changed(current.lux)) {
+    _interval = _minInterval;
+    powerDown(false);
+  } else if (_interval < _maxInterval) {
+    _interval = (_interval > _maxInterval / 2) ? _maxInterval : _interval * 2;
+  } else {
+    powerDown(true);
+  }
+
+  _last = current;
+  _primed = true;
+  if (reading)
+    *reading = current;
+  return true;
+}
+
+/*!
+ *    @brief  Move the sensor in or out of power save mode, if allowed
+ *    @param  enable True to enter power save mode
+ */
+void Adafruit_VEML7700_Sampler::powerDown(bool enable) {
+  if (!_sensor || (enable == _poweredDown) || (enable && !_powerSave))
+    return;
+  if (enable)
+    _sensor->setPowerSaveMode(_powerSaveMode);
+  _sensor->powerSaveEnable(enable);
+  _poweredDown = enable;
+}
@@ -0,0 +1,64 @@
+/*!
+ *  @file Adafruit_VEML7700_Sampler.h
+ *
+ * 	Adaptive rate sampling for the VEML7700
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_SAMPLER_H
+#define _ADAFRUIT_VEML7700_SAMPLER_H
+
+#include "Adafruit_VEML7700.h"
+
+/*!
+ *    @brief  Takes readings at an interval that adapts to the light. Every
+ *            reading that matches the previous one doubles the interval, up
+ *            to a maximum, and any significant change drops it straight back
+ *            to the minimum. Optionally puts the sensor in power save mode
+ *            while the interval is at its maximum.
+ */
+class Adafruit_VEML7700_Sampler {
+public:
+  Adafruit_VEML7700_Sampler(Adafruit_VEML7700 *sensor,
+                            uint32_t minInterval = 1000,
+                            uint32_t maxInterval = 60000);
+
+  void setIntervals(uint32_t minInterval, uint32_t maxInterval);
+  void setThreshold(float relative, float absolute = 0);
+  void setMethod(luxMethod method);
+  void setPowerSave(bool enable, uint8_t mode = VEML7700_POWERSAVE_MODE4);
+  void reset(void);
+
+  bool update(veml7700_reading_t *reading = NULL);
+  bool changed(float lux) const;
+
+  /*! @returns Current interval between readings in milliseconds */
+  uint32_t interval(void) const { return _interval; }
+  /*! @returns Lux of the most recent reading */
+  float lastLux(void) const { return _last.lux; }
+  /*! @returns True if the sensor was put in power save mode */
+  bool poweredDown(void) const { return _poweredDown; }
+
+private:
+  void powerDown(bool enable);
+
+  Adafruit_VEML7700 *_sensor;
+  veml7700_reading_t _last;
+  luxMethod _method;
+  uint32_t _minInterval, _maxInterval, _interval;
+  unsigned long _lastSample;
+  float _relative, _absolute;
+  bool _primed, _powerSave, _poweredDown;
+  uint8_t _powerSaveMode;
+};
+
+#endif
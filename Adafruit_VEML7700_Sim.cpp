@@ -0,0 +1,164 @@
+/*!
+ *  @file Adafruit_VEML7700_Sim.cpp
+ *
+ * 	Simulated VEML7700 and scripted light profiles
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Sim.h"
+#include <math.h>
+
+/*!
+ *    @brief  Instantiates a simulator in constant darkness at time 0
+ */
+Adafruit_VEML7700_Sim::Adafruit_VEML7700_Sim(void) {
+  setProfile(VEML7700_SIM_DARK, 0);
+  setSensitivity(1);
+  reset();
+}
+
+/*!
+ *    @brief  Select the light profile. Parameters that a profile does not
+ * list are ignored.
+ *    @param  profile The profile to play back
+ *    @param  level Base illuminance in lux
+ *    @param  level2 Second illuminance in lux for STEP and SUNRISE, ripple
+ * depth as a fraction of level for FLUORESCENT
+ *    @param  period Step interval, ramp length, cloud interval or ripple
+ * period in milliseconds. A 10 ms ripple matches 50 Hz mains.
+ *    @param  seed Seed for the cloud pattern
+ */
+void Adafruit_VEML7700_Sim::setProfile(veml7700_sim_profile_t profile,
+                                       float level, float level2,
+                                       uint32_t period, uint32_t seed) {
+  _profile = profile;
+  _level = level;
+  _level2 = level2;
+  _period = period ? period : 1;
+  _seed = seed;
+}
+
+/*!
+ *    @brief  Scale the simulated unit's response, to model unit to unit
+ * variation
+ *    @param  sensitivity Counts produced relative to a nominal unit
+ */
+void Adafruit_VEML7700_Sim::setSensitivity(float sensitivity) {
+  _sensitivity = sensitivity;
+}
+
+/*!
+ *    @brief  Rewind the virtual clock and clear the counters
+ */
+void Adafruit_VEML7700_Sim::reset(void) {
+  _now = 0;
+  _lastLux = 0;
+  _integrations = 0;
+  _saturations = 0;
+}
+
+/*!
+ *    @brief  Advance the virtual clock without integrating
+ *    @param  ms Milliseconds to advance by
+ */
+void Adafruit_VEML7700_Sim::advance(uint32_t ms) { _now += ms; }
+
+/*!
+ *    @brief  Cloud transmission for one cloud interval
+ *    @param  segment Index of the interval
+ *    @returns Fraction of light let through, 0.2 to 1
+ */
+float Adafruit_VEML7700_Sim::cloudAt(uint32_t segment) const {
+  // integer hash so any segment can be looked up without replaying
+  uint32_t x = (segment + 1) * 2654435761UL ^ _seed * 2246822519UL;
+  x ^= x >> 15;
+  x *= 2246822519UL;
+  x ^= x >> 13;
+  return 0.2 + 0.8 * (x & 0xFFFF) / 65535.0;
+}
+
+/*!
+ *    @brief  Get the illuminance of the profile at a point in time
+ *    @param  time Virtual time in milliseconds
+ *    @returns Illuminance in lux
+ */
+float Adafruit_VEML7700_Sim::lightAt(uint32_t time) const {
+  switch (_profile) {
+  case VEML7700_SIM_CONSTANT:
+    return _level;
+  case VEML7700_SIM_STEP:
+    return ((time / _period) & 1) ? _level2 : _level;
+  case VEML7700_SIM_SUNRISE: {
+    if (time >= _period)
+      return _level2;
+    // light grows exponentially, so ramp the log of it
+    float from = log(_level > 0.001 ? _level : 0.001);
+    float to = log(_level2 > 0.001 ? _level2 : 0.001);
+    return exp(from + (to - from) * time / _period);
+  }
+  case VEML7700_SIM_CLOUDS: {
+    // blend between interval values so edges are soft
+    uint32_t segment = time / _period;
+    float frac = (float)(time % _period) / _period;
+    float a = cloudAt(segment);
+    float b = cloudAt(segment + 1);
+    return _level * (a + (b - a) * frac);
+  }
+  case VEML7700_SIM_FLUORESCENT:
+    return _level * (1 + _level2 * sin(2 * M_PI * (time % _period) / _period));
+  case VEML7700_SIM_DARK:
+  default:
+    return 0;
+  }
+}
+
+/*!
+ *    @brief  Run one integration, advancing the clock by the integration time
+ *    @param  gain Gain setting, one of VEML7700_GAIN_*
+ *    @param  it Integration time setting, one of VEML7700_IT_*
+ *    @returns Raw ALS count the sensor would latch
+ */
+uint16_t Adafruit_VEML7700_Sim::integrate(uint8_t gain, uint8_t it) {
+  int ms = veml7700_integration_time_value(it);
+  if ((ms <= 0) || (veml7700_gain_value(gain) <= 0))
+    return 0;
+
+  float sum = 0;
+  for (int i = 0; i < ms; i++)
+    sum += lightAt(_now + i);
+  _now += ms;
+  _integrations++;
+  _lastLux = sum / ms;
+
+  // The sensor reports linear lux that correctLux() maps back to true lux,
+  // so invert the correction. Newton converges in a few steps because the
+  // correction is close to the identity.
+  float linear = _lastLux;
+  for (uint8_t i = 0; i < 4; i++) {
+    float err = veml7700_correct_lux(linear) - _lastLux;
+    float slope = (veml7700_correct_lux(linear * 1.001 + 0.001) -
+                   veml7700_correct_lux(linear)) /
+                  (linear * 0.001 + 0.001);
+    linear -= err / slope;
+  }
+
+  float counts = _sensitivity * linear / veml7700_resolution(gain, it);
+  if (counts >= 65535) {
+    _saturations++;
+    return 65535;
+  }
+  return counts > 0 ? (uint16_t)(counts + 0.5) : 0;
+}
+
+/*!
+ *    @brief  Integrate callback for auto-range policies
+ *    @param  sim Pointer to the Adafruit_VEML7700_Sim to integrate with
+ *    @param  gain Gain setting, one of VEML7700_GAIN_*
+ *    @param  it Integration time setting, one of VEML7700_IT_*
+ *    @returns Raw ALS count the sensor would latch
+ */
+uint16_t Adafruit_VEML7700_Sim::integrateCallback(void *sim, uint8_t gain,
+                                                  uint8_t it) {
+  return ((Adafruit_VEML7700_Sim *)sim)->integrate(gain, it);
+}
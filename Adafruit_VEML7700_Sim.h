@@ -0,0 +1,75 @@
+/*!
+ *  @file Adafruit_VEML7700_Sim.h
+ *
+ * 	Simulated VEML7700 and scripted light profiles
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_SIM_H
+#define _ADAFRUIT_VEML7700_SIM_H
+
+#include <stdint.h>
+
+#include "Adafruit_VEML7700_Lux.h"
+
+/** Scripted light profiles */
+typedef enum {
+  VEML7700_SIM_CONSTANT,    ///< level lux
+  VEML7700_SIM_STEP,        ///< Alternates level and level2 every period ms
+  VEML7700_SIM_SUNRISE,     ///< Log ramp from level to level2 over period ms
+  VEML7700_SIM_CLOUDS,      ///< level dimmed by random clouds every period ms
+  VEML7700_SIM_FLUORESCENT, ///< level with level2 ripple depth, period ms
+  VEML7700_SIM_DARK,        ///< No light at all
+} veml7700_sim_profile_t;
+
+/*!
+ *    @brief  Simulates a VEML7700 exposed to a scripted light profile on a
+ *            virtual clock. Each integration advances the clock by the
+ *            integration time and returns the count the sensor would have
+ *            latched, including saturation and the non-linearity that the
+ *            App Note correction undoes. No hardware or real time is used,
+ *            so runs are fast and reproducible.
+ */
+class Adafruit_VEML7700_Sim {
+public:
+  Adafruit_VEML7700_Sim(void);
+
+  void setProfile(veml7700_sim_profile_t profile, float level,
+                  float level2 = 0, uint32_t period = 1000,
+                  uint32_t seed = 1);
+  void setSensitivity(float sensitivity);
+  void reset(void);
+
+  float lightAt(uint32_t time) const;
+  uint16_t integrate(uint8_t gain, uint8_t it);
+  void advance(uint32_t ms);
+
+  /*! @returns Current virtual time in milliseconds */
+  uint32_t now(void) const { return _now; }
+  /*! @returns True mean lux over the most recent integration */
+  float lastLux(void) const { return _lastLux; }
+  /*! @returns Number of integrations since reset() */
+  uint32_t integrations(void) const { return _integrations; }
+  /*! @returns Number of saturated integrations since reset() */
+  uint32_t saturations(void) const { return _saturations; }
+
+  static uint16_t integrateCallback(void *sim, uint8_t gain, uint8_t it);
+
+private:
+  float cloudAt(uint32_t segment) const;
+
+  veml7700_sim_profile_t _profile;
+  float _level, _level2, _sensitivity, _lastLux;
+  uint32_t _period, _seed, _now, _integrations, _saturations;
+};
+
+#endif
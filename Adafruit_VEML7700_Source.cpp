@@ -0,0 +1,146 @@
+/*!
+ *  @file Adafruit_VEML7700_Source.cpp
+ *
+ * 	Light source classification from the VEML7700 WHITE to ALS ratio
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Source.h"
+
+// Rough color temperature of a thermal source against its WHITE to ALS
+// ratio in 16.16, the infrared share growing as the source gets cooler
+static const uint32_t cctRatio[] = {91750, 117965, 157286, 209715, 262144};
+static const uint16_t cctKelvin[] = {6500, 5000, 4000, 3000, 2700};
+
+/*!
+ *    @brief  Instantiates a classifier
+ *    @param  shift Smoothing, each reading moves the ratio 1/2^shift of the
+ * way to its own
+ */
+Adafruit_VEML7700_Source::Adafruit_VEML7700_Source(uint8_t shift)
+    : _shift(shift) {
+  setBands(VEML7700_SOURCE_LED_MAX, VEML7700_SOURCE_FLUORESCENT_MAX,
+           VEML7700_SOURCE_DAYLIGHT_MAX);
+  setMaxDeviation(0.05);
+  reset();
+}
+
+/*!
+ *    @brief  Set the ratio bands of the source types. Ratios above daylight
+ * are incandescent.
+ *    @param  led Highest WHITE to ALS ratio for LED
+ *    @param  fluorescent Highest ratio for fluorescent
+ *    @param  daylight Highest ratio for daylight
+ */
+void Adafruit_VEML7700_Source::setBands(float led, float fluorescent,
+                                        float daylight) {
+  _led = led * 65536;
+  _fluorescent = fluorescent * 65536;
+  _daylight = daylight * 65536;
+}
+
+/*!
+ *    @brief  Set how steady the ratio must be for a source to be reported
+ *    @param  deviation Largest mean deviation as a fraction of the ratio
+ */
+void Adafruit_VEML7700_Source::setMaxDeviation(float deviation) {
+  _maxDeviation = deviation * 65536;
+}
+
+/*!
+ *    @brief  Forget all readings
+ */
+void Adafruit_VEML7700_Source::reset(void) {
+  _ratio = 0;
+  _deviation = 0;
+  _count = 0;
+}
+
+/*!
+ *    @brief  Add a pair of counts latched from the same integration
+ *    @param  als Raw ALS channel count
+ *    @param  white Raw WHITE channel count
+ *    @returns True if the counts were used, false if too dark or saturated
+ */
+bool Adafruit_VEML7700_Source::add(uint16_t als, uint16_t white) {
+  if ((als < VEML7700_SOURCE_MIN_ALS) || (als == 0xFFFF) || (white == 0xFFFF))
+    return false;
+
+  int32_t ratio = ((uint32_t)white << 16) / als;
+  if (!_count) {
+    _ratio = ratio;
+  } else {
+    int32_t error = ratio - _ratio;
+    _ratio += error >> _shift;
+    _deviation += ((error < 0 ? -error : error) - _deviation) >> _shift;
+  }
+  _count++;
+  return true;
+}
+
+/*!
+ *    @brief  Add a reading
+ *    @param  reading The reading
+ *    @returns True if the reading was used, false if too dark or saturated
+ */
+bool Adafruit_VEML7700_Source::add(const veml7700_reading_t *reading) {
+  if (!reading)
+    return false;
+  return add(reading->als, reading->white);
+}
+
+/*!
+ *    @brief  Check whether the ratio has settled
+ *    @returns True after enough readings for the smoothing, with the
+ * deviation within the limit
+ */
+bool Adafruit_VEML7700_Source::steady(void) const {
+  if (_count < (1UL << _shift))
+    return false;
+  return ((uint64_t)_deviation << 16) <= (uint64_t)_ratio * _maxDeviation;
+}
+
+/*!
+ *    @brief  Estimate the light source
+ *    @returns The source type, VEML7700_SOURCE_UNKNOWN until steady()
+ */
+veml7700_source_t Adafruit_VEML7700_Source::source(void) const {
+  if (!steady())
+    return VEML7700_SOURCE_UNKNOWN;
+  if ((uint32_t)_ratio <= _led)
+    return VEML7700_SOURCE_LED;
+  if ((uint32_t)_ratio <= _fluorescent)
+    return VEML7700_SOURCE_FLUORESCENT;
+  if ((uint32_t)_ratio <= _daylight)
+    return VEML7700_SOURCE_DAYLIGHT;
+  return VEML7700_SOURCE_INCANDESCENT;
+}
+
+/*!
+ *    @brief  Estimate the correlated color temperature. Only thermal
+ * sources have an infrared share that follows their color, so LED and
+ * fluorescent light give no estimate.
+ *    @returns Kelvin, roughly, or 0 for no estimate
+ */
+uint16_t Adafruit_VEML7700_Source::cct(void) const {
+  veml7700_source_t type = source();
+  if ((type != VEML7700_SOURCE_DAYLIGHT) &&
+      (type != VEML7700_SOURCE_INCANDESCENT))
+    return 0;
+
+  uint32_t ratio = _ratio;
+  const uint8_t last = sizeof(cctKelvin) / sizeof(cctKelvin[0]) - 1;
+  if (ratio <= cctRatio[0])
+    return cctKelvin[0];
+  if (ratio >= cctRatio[last])
+    return cctKelvin[last];
+
+  uint8_t i = 1;
+  while (ratio > cctRatio[i])
+    i++;
+  // linear between the table points around the ratio
+  int32_t span = cctKelvin[i] - cctKelvin[i - 1];
+  return cctKelvin[i - 1] + span * (int32_t)(ratio - cctRatio[i - 1]) /
+                                (int32_t)(cctRatio[i] - cctRatio[i - 1]);
+}
@@ -0,0 +1,75 @@
+/*!
+ *  @file Adafruit_VEML7700_Source.h
+ *
+ * 	Light source classification from the VEML7700 WHITE to ALS ratio
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_SOURCE_H
+#define _ADAFRUIT_VEML7700_SOURCE_H
+
+#include "Adafruit_VEML7700.h"
+
+#define VEML7700_SOURCE_LED_MAX 1.15         ///< Default top of the LED band
+#define VEML7700_SOURCE_FLUORESCENT_MAX 1.40 ///< Default top of fluorescent
+#define VEML7700_SOURCE_DAYLIGHT_MAX 2.60    ///< Default top of daylight
+#define VEML7700_SOURCE_MIN_ALS 100 ///< Fewest ALS counts for a usable ratio
+
+/** Light source types */
+typedef enum {
+  VEML7700_SOURCE_UNKNOWN,      ///< Too dark, too few readings, or unsteady
+  VEML7700_SOURCE_LED,          ///< White LED, almost no infrared
+  VEML7700_SOURCE_FLUORESCENT,  ///< Fluorescent, little infrared
+  VEML7700_SOURCE_DAYLIGHT,     ///< Daylight
+  VEML7700_SOURCE_INCANDESCENT, ///< Incandescent or halogen, mostly infrared
+} veml7700_source_t;
+
+/*!
+ *    @brief  Estimates the type of light source from the ratio of the
+ *            WHITE channel, which reaches into the infrared, to the ALS
+ *            channel, which follows the eye. The smoothed ratio and its
+ *            mean deviation are kept in 16.16 fixed point with O(1) work
+ *            per reading. A source is reported only once the ratio has
+ *            settled, since a ratio that wanders means mixed or changing
+ *            light. The default bands are starting points, calibrate them
+ *            against the sources at hand with ratio().
+ */
+class Adafruit_VEML7700_Source {
+public:
+  Adafruit_VEML7700_Source(uint8_t shift = 3);
+
+  void setBands(float led, float fluorescent, float daylight);
+  void setMaxDeviation(float deviation);
+  void reset(void);
+
+  bool add(uint16_t als, uint16_t white);
+  bool add(const veml7700_reading_t *reading);
+
+  veml7700_source_t source(void) const;
+  uint16_t cct(void) const;
+  bool steady(void) const;
+
+  /*! @returns Smoothed WHITE to ALS ratio */
+  float ratio(void) const { return _ratio / 65536.0; }
+  /*! @returns Smoothed mean deviation of the ratio */
+  float deviation(void) const { return _deviation / 65536.0; }
+  /*! @returns Number of readings used since reset() */
+  uint32_t count(void) const { return _count; }
+
+private:
+  uint8_t _shift;
+  int32_t _ratio, _deviation; // 16.16
+  uint32_t _led, _fluorescent, _daylight, _maxDeviation; // 16.16
+  uint32_t _count;
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*!
+ *  @file Adafruit_VEML7700_Stats.cpp
+ *
+ * 	Streaming statistics over VEML7700 readings
+ *
+ * 	Mean and variance use Welford's update, which stays accurate for the
+ * 	large lux values where a running sum of squares would not. In sliding
+ * 	mode removing a value undoes its update, which cancels badly once a
+ * 	window of bright values gives way to dim ones, so mean and variance
+ * 	are recomputed exactly from the window each time it wraps around, and
+ * 	as soon as a removed value dwarfs the mean of what is left, so the
+ * 	error does not linger until the next wraparound. That is O(1) work per
+ * 	value on average, plus O(size) per removal in the last sixteenth of a
+ * 	bright to dim transition. The min and max queues hold ring
+ * 	positions of values that could still become the window's min or max,
+ * 	in order, so the answer is always at the front.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Stats.h"
+
+#include <math.h>
+
+/*!
+ *    @brief  Instantiates an accumulator over everything added since the
+ * last reset()
+ */
+Adafruit_VEML7700_Stats::Adafruit_VEML7700_Stats(void)
+    : _values(NULL), _minQueue(NULL), _maxQueue(NULL), _size(0) {
+  reset();
+}
+
+/*!
+ *    @brief  Instantiates an accumulator over the last size values
+ *    @param  values Storage for size values
+ *    @param  minQueue Storage for size entries
+ *    @param  maxQueue Storage for size entries
+ *    @param  size Number of values in the window
+ */
+Adafruit_VEML7700_Stats::Adafruit_VEML7700_Stats(float *values,
+                                                 uint16_t *minQueue,
+                                                 uint16_t *maxQueue,
+                                                 uint16_t size)
+    : _values(values), _minQueue(minQueue), _maxQueue(maxQueue),
+      _size((values && minQueue && maxQueue) ? size : 0) {
+  reset();
+}
+
+/*!
+ *    @brief  Empty the window
+ */
+void Adafruit_VEML7700_Stats::reset(void) {
+  _pos = _minHead = _minLen = _maxHead = _maxLen = 0;
+  _count = 0;
+  _mean = _m2 = _min = _max = 0;
+}
+
+/*!
+ *    @brief  Add a lux value, dropping the oldest one if the sliding window
+ * is full
+ *    @param  lux The value to add
+ */
+void Adafruit_VEML7700_Stats::add(float lux) {
+  if (!_size) {
+    if (!_count || (lux < _min))
+      _min = lux;
+    if (!_count || (lux > _max))
+      _max = lux;
+    push(lux);
+    return;
+  }
+
+  float removed = 0;
+  if (_count == _size) {
+    removed = _values[_pos];
+    pop(removed);
+    if (_minLen && (_minQueue[_minHead] == _pos)) {
+      _minHead = (_minHead + 1) % _size;
+      _minLen--;
+    }
+    if (_maxLen && (_maxQueue[_maxHead] == _pos)) {
+      _maxHead = (_maxHead + 1) % _size;
+      _maxLen--;
+    }
+  }
+
+  _values[_pos] = lux;
+  push(lux);
+
+  // drop entries from the back that the new value outranks for good
+  while (_minLen &&
+         (_values[_minQueue[(_minHead + _minLen - 1) % _size]] >= lux))
+    _minLen--;
+  _minQueue[(_minHead + _minLen++) % _size] = _pos;
+
+  while (_maxLen &&
+         (_values[_maxQueue[(_maxHead + _maxLen - 1) % _size]] <= lux))
+    _maxLen--;
+  _maxQueue[(_maxHead + _maxLen++) % _size] = _pos;
+
+  _pos = (_pos + 1) % _size;
+  // removing a value much larger than what is left cancels most digits
+  if ((!_pos && (_count == _size)) || (fabs(removed) > 16 * fabs(_mean)))
+    recompute();
+}
+
+/*!
+ *    @brief  Add the lux of a reading
+ *    @param  reading The reading to add
+ */
+void Adafruit_VEML7700_Stats::add(const veml7700_reading_t *reading) {
+  if (reading)
+    add(reading->lux);
+}
+
+/*!
+ *    @brief  Welford update for a value entering the window
+ *    @param  lux The value
+ */
+void Adafruit_VEML7700_Stats::push(float lux) {
+  _count++;
+  double delta = lux - _mean;
+  _mean += delta / _count;
+  _m2 += delta * (lux - _mean);
+}
+
+/*!
+ *    @brief  Reverse Welford update for a value leaving the window
+ *    @param  lux The value
+ */
+void Adafruit_VEML7700_Stats::pop(float lux) {
+  if (--_count == 0) {
+    _mean = _m2 = 0;
+    return;
+  }
+  double delta = lux - _mean;
+  _mean -= delta / _count;
+  _m2 -= delta * (lux - _mean);
+}
+
+/*!
+ *    @brief  Replace the running mean and variance with a two pass
+ * computation over the window, dropping the rounding error of every value
+ * removed since the last one
+ */
+void Adafruit_VEML7700_Stats::recompute(void) {
+  double sum = 0;
+  for (uint16_t i = 0; i < _count; i++)
+    sum += _values[i];
+  _mean = sum / _count;
+
+  double m2 = 0;
+  for (uint16_t i = 0; i < _count; i++) {
+    double delta = _values[i] - _mean;
+    m2 += delta * delta;
+  }
+  _m2 = m2;
+}
+
+/*!
+ *    @brief  Get the sample variance of the window
+ *    @returns Variance in lux squared, 0 with fewer than 2 values
+ */
+float Adafruit_VEML7700_Stats::variance(void) const {
+  // removals between recomputes can leave a rounding error either side
+  if ((_count < 2) || (_m2 <= 0))
+    return 0;
+  return _m2 / (_count - 1);
+}
+
+/*!
+ *    @brief  Get the lowest value in the window
+ *    @returns Lowest lux, 0 if empty
+ */
+float Adafruit_VEML7700_Stats::minimum(void) const {
+  if (!_size)
+    return _min;
+  return _minLen ? _values[_minQueue[_minHead]] : 0;
+}
+
+/*!
+ *    @brief  Get the highest value in the window
+ *    @returns Highest lux, 0 if empty
+ */
+float Adafruit_VEML7700_Stats::maximum(void) const {
+  if (!_size)
+    return _max;
+  return _maxLen ? _values[_maxQueue[_maxHead]] : 0;
+}
+
+/*!
+ *    @brief  Fill in a summary of the window
+ *    @param  stats Pointer to the structure to fill in
+ */
+void Adafruit_VEML7700_Stats::summary(veml7700_stats_t *stats) const {
+  if (!stats)
+    return;
+  stats->count = _count;
+  stats->mean = _mean;
+  stats->variance = variance();
+  stats->min = minimum();
+  stats->max = maximum();
+}
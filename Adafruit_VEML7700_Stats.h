@@ -0,0 +1,72 @@
+/*!
+ *  @file Adafruit_VEML7700_Stats.h
+ *
+ * 	Streaming statistics over VEML7700 readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_STATS_H
+#define _ADAFRUIT_VEML7700_STATS_H
+
+#include "Adafruit_VEML7700.h"
+
+/** Summary of the readings in a window */
+typedef struct {
+  uint32_t count; ///< Number of readings
+  float mean;     ///< Mean lux
+  float variance; ///< Sample variance of lux, 0 with fewer than 2 readings
+  float min;      ///< Lowest lux
+  float max;      ///< Highest lux
+} veml7700_stats_t;
+
+/*!
+ *    @brief  Keeps the count, mean, variance, min and max of a stream of lux
+ *            values with O(1) work per value on average. Without storage it
+ *            summarizes everything added since the last reset(), for one
+ *            summary per fixed window. With caller supplied storage for N
+ *            values it summarizes the last N values, tracking min and max
+ *            with monotonic queues.
+ */
+class Adafruit_VEML7700_Stats {
+public:
+  Adafruit_VEML7700_Stats(void);
+  Adafruit_VEML7700_Stats(float *values, uint16_t *minQueue,
+                          uint16_t *maxQueue, uint16_t size);
+
+  void reset(void);
+  void add(float lux);
+  void add(const veml7700_reading_t *reading);
+  void summary(veml7700_stats_t *stats) const;
+
+  /*! @returns Number of values in the window */
+  uint32_t count(void) const { return _count; }
+  /*! @returns Mean of the values in the window */
+  float mean(void) const { return _mean; }
+  float variance(void) const;
+  float minimum(void) const;
+  float maximum(void) const;
+
+private:
+  void push(float lux);
+  void pop(float lux);
+  void recompute(void);
+
+  float *_values;
+  uint16_t *_minQueue, *_maxQueue;
+  uint16_t _size, _pos;
+  uint16_t _minHead, _minLen, _maxHead, _maxLen;
+  uint32_t _count;
+  double _mean, _m2; // float on AVR, recomputed on wraparound and drops
+  float _min, _max;
+};
+
+#endif
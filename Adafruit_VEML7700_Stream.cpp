@@ -0,0 +1,265 @@
+/*!
+ *  @file Adafruit_VEML7700_Stream.cpp
+ *
+ * 	COBS framed, CRC checked binary packets for streaming VEML7700
+ * 	readings over a serial link
+ *
+ * 	Everything but the writer is free of Arduino dependencies, so host
+ * 	receivers build it unchanged.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_Stream.h"
+#include <string.h>
+
+/*!
+ *    @brief  CRC-16/CCITT-FALSE, bitwise to keep tables out of flash
+ *    @param  data Bytes to check
+ *    @param  length Number of bytes
+ *    @returns CRC
+ */
+uint16_t veml7700_crc16(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+/*!
+ *    @brief  COBS encode, without the trailing delimiter
+ *    @param  data Bytes to encode
+ *    @param  length Number of bytes
+ *    @param  buffer Room for length + 1 + length / 254 bytes
+ *    @returns Number of bytes encoded
+ */
+size_t veml7700_cobs_encode(const uint8_t *data, size_t length,
+                            uint8_t *buffer) {
+  size_t code = 0, n = 1;
+  buffer[code] = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (data[i]) {
+      buffer[n++] = data[i];
+      buffer[code]++;
+    }
+    if (!data[i] || (buffer[code] == 0xFF)) {
+      code = n++;
+      buffer[code] = 1;
+    }
+  }
+  return n;
+}
+
+/*!
+ *    @brief  COBS decode, without the trailing delimiter
+ *    @param  data Bytes to decode
+ *    @param  length Number of bytes
+ *    @param  buffer Room for length bytes
+ *    @returns Number of bytes decoded, 0 if the encoding is bad
+ */
+size_t veml7700_cobs_decode(const uint8_t *data, size_t length,
+                            uint8_t *buffer) {
+  size_t i = 0, n = 0;
+  while (i < length) {
+    uint8_t code = data[i++];
+    if (!code || (i + code - 1 > length))
+      return 0;
+    for (uint8_t j = 1; j < code; j++) {
+      if (!data[i])
+        return 0;
+      buffer[n++] = data[i++];
+    }
+    if ((code != 0xFF) && (i < length))
+      buffer[n++] = 0;
+  }
+  return n;
+}
+
+/*!
+ *    @brief  Build the packet for a payload, CRC, COBS and delimiter
+ *    @param  payload The payload
+ *    @param  length Bytes in the payload, up to VEML7700_STREAM_PAYLOAD_MAX
+ *    @param  buffer Room for VEML7700_STREAM_PACKET_MAX bytes
+ *    @returns Bytes in the packet, 0 if the payload is too long
+ */
+size_t veml7700_stream_packet(const uint8_t *payload, size_t length,
+                              uint8_t *buffer) {
+  uint8_t raw[VEML7700_STREAM_PAYLOAD_MAX + 2];
+  if (length > VEML7700_STREAM_PAYLOAD_MAX)
+    return 0;
+
+  memcpy(raw, payload, length);
+  uint16_t crc = veml7700_crc16(payload, length);
+  raw[length] = crc;
+  raw[length + 1] = crc >> 8;
+
+  size_t n = veml7700_cobs_encode(raw, length + 2, buffer);
+  buffer[n++] = 0;
+  return n;
+}
+
+/*!
+ *    @brief  Build the payload of a reading packet
+ *    @param  record The reading
+ *    @param  sequence Sequence number of the packet
+ *    @param  payload Room for VEML7700_STREAM_READING_SIZE bytes
+ *    @returns Bytes in the payload
+ */
+uint8_t veml7700_stream_reading(const veml7700_log_record_t *record,
+                                uint16_t sequence, uint8_t *payload) {
+  payload[0] = VEML7700_STREAM_READING;
+  payload[1] = sequence;
+  payload[2] = sequence >> 8;
+  for (uint8_t i = 0; i < 4; i++)
+    payload[3 + i] = record->timestamp >> (8 * i);
+  payload[7] = record->als;
+  payload[8] = record->als >> 8;
+  payload[9] = record->white;
+  payload[10] = record->white >> 8;
+  payload[11] = (record->gain & 0x03) |
+                ((record->integrationTime & 0x0F) << 2) |
+                (record->corrected ? VEML7700_LOG_CORRECTED : 0);
+  return VEML7700_STREAM_READING_SIZE;
+}
+
+/*!
+ *    @brief  Parse the payload of a reading packet
+ *    @param  payload The payload
+ *    @param  length Bytes in the payload
+ *    @param  sequence Set to the packet's sequence number
+ *    @param  record Set to the reading
+ *    @returns True if the payload is a reading
+ */
+bool veml7700_stream_parse_reading(const uint8_t *payload, size_t length,
+                                   uint16_t *sequence,
+                                   veml7700_log_record_t *record) {
+  if ((length != VEML7700_STREAM_READING_SIZE) ||
+      (payload[0] != VEML7700_STREAM_READING) || (payload[11] & 0x80))
+    return false;
+
+  *sequence = payload[1] | ((uint16_t)payload[2] << 8);
+  record->timestamp = 0;
+  for (uint8_t i = 0; i < 4; i++)
+    record->timestamp |= (uint32_t)payload[3 + i] << (8 * i);
+  record->als = payload[7] | ((uint16_t)payload[8] << 8);
+  record->white = payload[9] | ((uint16_t)payload[10] << 8);
+  record->gain = payload[11] & 0x03;
+  record->integrationTime = (payload[11] >> 2) & 0x0F;
+  record->corrected = payload[11] & VEML7700_LOG_CORRECTED;
+  return true;
+}
+
+/*!
+ *    @brief  Instantiates a decoder
+ */
+Adafruit_VEML7700_StreamDecoder::Adafruit_VEML7700_StreamDecoder(void)
+    : _crcErrors(0), _framingErrors(0) {
+  reset();
+}
+
+/*!
+ *    @brief  Drop any partial packet and clear the error counts
+ */
+void Adafruit_VEML7700_StreamDecoder::reset(void) {
+  _length = 0;
+  _overflow = false;
+  _crcErrors = _framingErrors = 0;
+}
+
+/*!
+ *    @brief  Feed the next received byte
+ *    @param  byte The byte
+ *    @returns Length of the payload if this byte completed a good packet,
+ * see payload(), otherwise 0
+ */
+size_t Adafruit_VEML7700_StreamDecoder::push(uint8_t byte) {
+  if (byte) {
+    if (_length < sizeof(_buffer))
+      _buffer[_length++] = byte;
+    else
+      _overflow = true;
+    return 0;
+  }
+
+  // a delimiter ends the packet, empty ones are just resynchronizing
+  uint8_t length = _length;
+  bool overflow = _overflow;
+  _length = 0;
+  _overflow = false;
+  if (!length)
+    return 0;
+
+  size_t n = overflow ? 0 : veml7700_cobs_decode(_buffer, length, _payload);
+  if (n < 3) {
+    _framingErrors++;
+    return 0;
+  }
+  n -= 2;
+  uint16_t crc = _payload[n] | ((uint16_t)_payload[n + 1] << 8);
+  if (crc != veml7700_crc16(_payload, n)) {
+    _crcErrors++;
+    return 0;
+  }
+  return n;
+}
+
+#if defined(ARDUINO)
+
+/*!
+ *    @brief  Instantiates a writer
+ *    @param  out Where to write, such as Serial
+ */
+Adafruit_VEML7700_StreamWriter::Adafruit_VEML7700_StreamWriter(Print *out)
+    : _out(out), _sequence(0), _synced(false) {}
+
+/*!
+ *    @brief  Write a reading packet
+ *    @param  reading The reading
+ *    @returns True if the whole packet was written
+ */
+bool Adafruit_VEML7700_StreamWriter::write(const veml7700_reading_t *reading) {
+  uint8_t payload[VEML7700_STREAM_READING_SIZE];
+  veml7700_log_record_t record;
+
+  if (!reading)
+    return false;
+  record.timestamp = reading->timestamp;
+  record.als = reading->als;
+  record.white = reading->white;
+  record.gain = reading->gain;
+  record.integrationTime = reading->integrationTime;
+  record.corrected = reading->corrected;
+
+  uint8_t length = veml7700_stream_reading(&record, _sequence++, payload);
+  return writePacket(payload, length);
+}
+
+/*!
+ *    @brief  Write a packet with any payload. The first packet is preceded
+ * by a delimiter so the receiver drops anything printed before it.
+ *    @param  payload The payload, first byte the packet type
+ *    @param  length Bytes in the payload
+ *    @returns True if the whole packet was written
+ */
+bool Adafruit_VEML7700_StreamWriter::writePacket(const uint8_t *payload,
+                                                 size_t length) {
+  uint8_t packet[VEML7700_STREAM_PACKET_MAX + 1];
+  size_t n = 0;
+
+  if (!_out)
+    return false;
+  if (!_synced) {
+    packet[n++] = 0;
+    _synced = true;
+  }
+  size_t encoded = veml7700_stream_packet(payload, length, packet + n);
+  if (!encoded)
+    return false;
+  n += encoded;
+  return _out->write(packet, n) == n;
+}
+
+#endif
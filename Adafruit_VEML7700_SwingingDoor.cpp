@@ -0,0 +1,167 @@
+/*!
+ *  @file Adafruit_VEML7700_SwingingDoor.cpp
+ *
+ * 	Swinging door trend compression for VEML7700 readings
+ *
+ * 	Two doors hinge at error above and below the last archived point. Each
+ * 	new value can only close them further: the upper door swings down to
+ * 	pass over value + error and the lower door swings up to pass under
+ * 	value - error. While the doors are still open a straight line from the
+ * 	archived point stays within error of every value since. Once they
+ * 	cross, a point at the previous value's time is archived and becomes the
+ * 	new hinge.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_VEML7700_SwingingDoor.h"
+
+/*!
+ *    @brief  Instantiates a compressor
+ *    @param  error Largest allowed difference in lux between an input value
+ * and the reconstructed trend
+ */
+Adafruit_VEML7700_SwingingDoor::Adafruit_VEML7700_SwingingDoor(float error) {
+  setError(error);
+  reset();
+}
+
+/*!
+ *    @brief  Set the error bound. Takes effect from the next archived point.
+ *    @param  error Largest allowed difference in lux
+ */
+void Adafruit_VEML7700_SwingingDoor::setError(float error) {
+  _error = (error < 0) ? -error : error;
+}
+
+/*!
+ *    @brief  Start a new series
+ */
+void Adafruit_VEML7700_SwingingDoor::reset(void) {
+  _anchorTime = _lastTime = 0;
+  _anchorLux = _lastLux = 0;
+  _upper = _lower = 0;
+  _inputs = _archived = 0;
+  _pending = false;
+}
+
+/*!
+ *    @brief  Hinge the doors on a newly archived point, fully open
+ *    @param  time Time of the point
+ *    @param  lux Value of the point
+ */
+void Adafruit_VEML7700_SwingingDoor::open(uint32_t time, float lux) {
+  _anchorTime = time;
+  _anchorLux = lux;
+  _upper = INFINITY;
+  _lower = -INFINITY;
+  _archived++;
+}
+
+/*!
+ *    @brief  Add a value. Times must not go backwards.
+ *    @param  time Time of the value in ms
+ *    @param  lux The value
+ *    @param  archiveTime Set to the time of the point to archive, if any
+ *    @param  archiveLux Set to the value of the point to archive, if any
+ *    @returns True if a point must be archived
+ */
+bool Adafruit_VEML7700_SwingingDoor::add(uint32_t time, float lux,
+                                         uint32_t *archiveTime,
+                                         float *archiveLux) {
+  _inputs++;
+
+  if (_inputs == 1) {
+    // the first value is always archived
+    open(time, lux);
+    _lastTime = time;
+    _lastLux = lux;
+    *archiveTime = time;
+    *archiveLux = lux;
+    return true;
+  }
+
+  bool archive = false;
+  uint32_t dt = time - _anchorTime;
+
+  if (dt) {
+    float upper = (lux + _error - _anchorLux) / dt;
+    float lower = (lux - _error - _anchorLux) / dt;
+    if (upper > _upper)
+      upper = _upper;
+    if (lower < _lower)
+      lower = _lower;
+
+    if (lower > upper) {
+      // doors crossed, archive the end of the segment and hinge on it
+      pivot(archiveTime, archiveLux);
+      archive = true;
+
+      dt = time - _anchorTime;
+      if (dt) {
+        _upper = (lux + _error - _anchorLux) / dt;
+        _lower = (lux - _error - _anchorLux) / dt;
+      }
+    } else {
+      _upper = upper;
+      _lower = lower;
+    }
+  }
+
+  _lastTime = time;
+  _lastLux = lux;
+  _pending = true;
+  return archive;
+}
+
+/*!
+ *    @brief  Archive the point at the last value's time on the line midway
+ * between the doors, and hinge on it. Any line between the doors is within
+ * error of every value since the previous hinge, so this keeps the bound
+ * where archiving the raw last value would not.
+ *    @param  archiveTime Set to the time of the point
+ *    @param  archiveLux Set to the value of the point
+ */
+void Adafruit_VEML7700_SwingingDoor::pivot(uint32_t *archiveTime,
+                                           float *archiveLux) {
+  float lux = _lastLux;
+  uint32_t dt = _lastTime - _anchorTime;
+  if (dt && isfinite(_upper) && isfinite(_lower))
+    lux = _anchorLux + (_upper + _lower) / 2 * dt;
+
+  *archiveTime = _lastTime;
+  *archiveLux = lux;
+  open(_lastTime, lux);
+}
+
+/*!
+ *    @brief  Add a reading
+ *    @param  reading The reading, its timestamp is used as the time
+ *    @param  archiveTime Set to the time of the point to archive, if any
+ *    @param  archiveLux Set to the value of the point to archive, if any
+ *    @returns True if a point must be archived
+ */
+bool Adafruit_VEML7700_SwingingDoor::add(const veml7700_reading_t *reading,
+                                         uint32_t *archiveTime,
+                                         float *archiveLux) {
+  if (!reading)
+    return false;
+  return add(reading->timestamp, reading->lux, archiveTime, archiveLux);
+}
+
+/*!
+ *    @brief  End the current segment, for example before a log is closed,
+ * so the trend reaches the last value added
+ *    @param  archiveTime Set to the time of the point to archive, if any
+ *    @param  archiveLux Set to the value of the point to archive, if any
+ *    @returns True if a point must be archived
+ */
+bool Adafruit_VEML7700_SwingingDoor::flush(uint32_t *archiveTime,
+                                           float *archiveLux) {
+  if (!_pending || (_lastTime == _anchorTime))
+    return false;
+
+  pivot(archiveTime, archiveLux);
+  _pending = false;
+  return true;
+}
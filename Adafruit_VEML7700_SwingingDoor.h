@@ -0,0 +1,58 @@
+/*!
+ *  @file Adafruit_VEML7700_SwingingDoor.h
+ *
+ * 	Swinging door trend compression for VEML7700 readings
+ *
+ * 	This is a library for the Adafruit VEML7700 breakout:
+ * 	http://www.adafruit.com/
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_VEML7700_SWINGINGDOOR_H
+#define _ADAFRUIT_VEML7700_SWINGINGDOOR_H
+
+#include "Adafruit_VEML7700.h"
+
+/*!
+ *    @brief  Lossy compression of a timestamped lux series into the points
+ *            of a piecewise linear trend. Interpolating linearly between the
+ *            archived points reproduces every input value to within the
+ *            error bound. Uses constant memory and O(1) work per value.
+ */
+class Adafruit_VEML7700_SwingingDoor {
+public:
+  Adafruit_VEML7700_SwingingDoor(float error = 1);
+
+  void setError(float error);
+  void reset(void);
+
+  bool add(uint32_t time, float lux, uint32_t *archiveTime,
+           float *archiveLux);
+  bool add(const veml7700_reading_t *reading, uint32_t *archiveTime,
+           float *archiveLux);
+  bool flush(uint32_t *archiveTime, float *archiveLux);
+
+  /*! @returns Number of values added since reset() */
+  uint32_t inputs(void) const { return _inputs; }
+  /*! @returns Number of points archived since reset() */
+  uint32_t archived(void) const { return _archived; }
+
+private:
+  void open(uint32_t time, float lux);
+  void pivot(uint32_t *archiveTime, float *archiveLux);
+
+  float _error;
+  uint32_t _anchorTime, _lastTime;
+  float _anchorLux, _lastLux;
+  float _upper, _lower; // slopes of the two doors
+  uint32_t _inputs, _archived;
+  bool _pending; // _last holds a value that is not archived yet
+};
+
+#endif
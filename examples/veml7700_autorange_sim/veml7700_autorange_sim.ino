@@ -0,0 +1,140 @@
+/* VEML7700 Auto-Range Simulation Example
+ *
+ * This example sketch compares auto-range policies against scripted light
+ * profiles using the simulated sensor, so no VEML7700 is needed. For every
+ * profile and policy it prints one CSV line:
+ *
+ *   profile,policy,readings,integrations,latency_ms,saturations,err_pct
+ *
+ * latency_ms is the total integration time spent, err_pct the mean error of
+ * the reported lux against the true light over the final integration.
+ * Real reads also wait on the bus and on the driver's safety margin, so
+ * latencies on hardware are longer, but the policies rank the same.
+ *
+ * The default policy is the App Note flow chart, which starts over from
+ * gain 1/8 and 100ms every time. The alternative below starts from the
+ * previous settings and steps one setting at a time. Either can be used on
+ * a real sensor with setAutoRange().
+ */
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Sim.h"
+
+const uint8_t gains[] = {VEML7700_GAIN_1_8, VEML7700_GAIN_1_4,
+                         VEML7700_GAIN_1, VEML7700_GAIN_2};
+const uint8_t intTimes[] = {VEML7700_IT_25MS,  VEML7700_IT_50MS,
+                            VEML7700_IT_100MS, VEML7700_IT_200MS,
+                            VEML7700_IT_400MS, VEML7700_IT_800MS};
+
+struct Profile {
+  const char *name;
+  veml7700_sim_profile_t profile;
+  float level, level2;
+  uint32_t period;
+};
+
+const Profile profiles[] = {
+    {"constant", VEML7700_SIM_CONSTANT, 500, 0, 1000},
+    {"step", VEML7700_SIM_STEP, 5, 20000, 3000},
+    {"sunrise", VEML7700_SIM_SUNRISE, 0.01, 50000, 60000},
+    {"clouds", VEML7700_SIM_CLOUDS, 30000, 0, 2000},
+    {"fluorescent", VEML7700_SIM_FLUORESCENT, 400, 0.5, 10},
+    {"dark", VEML7700_SIM_DARK, 0, 0, 1000},
+};
+
+uint8_t indexOf(const uint8_t *list, uint8_t len, uint8_t value) {
+  for (uint8_t i = 0; i < len; i++) {
+    if (list[i] == value) return i;
+  }
+  return 0;
+}
+
+// Keep the previous settings and step one at a time until the count lands
+// between 100 and 10000.
+uint16_t stickyAutoRange(veml7700_integrate_t integrate, void *context,
+                         uint8_t *gain, uint8_t *it, bool *useCorrection) {
+  uint8_t g = indexOf(gains, 4, *gain);
+  uint8_t t = indexOf(intTimes, 6, *it);
+  uint16_t ALS = integrate(context, gains[g], intTimes[t]);
+
+  for (uint8_t steps = 0; steps < 10; steps++) {
+    if (ALS > 10000) {
+      if (t > 0) t--;
+      else if (g > 0) g--;
+      else break;
+    } else if (ALS < 100) {
+      if (g < 3) g++;
+      else if (t < 5) t++;
+      else break;
+    } else {
+      break;
+    }
+    ALS = integrate(context, gains[g], intTimes[t]);
+  }
+
+  *gain = gains[g];
+  *it = intTimes[t];
+  // the App Note only corrects readings taken at the low gains
+  *useCorrection = (g < 2);
+  return ALS;
+}
+
+const uint16_t READINGS = 60;
+const uint32_t SAMPLE_PERIOD = 1000; // ms between requested readings
+
+Adafruit_VEML7700_Sim sim;
+
+void run(const Profile &p, const char *name, veml7700_autorange_t policy) {
+  sim.setProfile(p.profile, p.level, p.level2, p.period);
+  sim.reset();
+
+  uint8_t gain = VEML7700_GAIN_1_8;
+  uint8_t it = VEML7700_IT_100MS;
+  uint32_t latency = 0;
+  float errSum = 0;
+  // error is relative, but never against less than one count of the most
+  // sensitive setting
+  float minLux = Adafruit_VEML7700::resolution(VEML7700_GAIN_2,
+                                               VEML7700_IT_800MS);
+
+  for (uint16_t i = 0; i < READINGS; i++) {
+    uint32_t start = sim.now();
+    bool useCorrection = false;
+    uint16_t ALS = policy(Adafruit_VEML7700_Sim::integrateCallback, &sim,
+                          &gain, &it, &useCorrection);
+    latency += sim.now() - start;
+
+    float lux = Adafruit_VEML7700::rawToLux(ALS, gain, it, useCorrection);
+    float truth = sim.lastLux();
+    errSum += fabs(lux - truth) / (truth > minLux ? truth : minLux);
+
+    uint32_t next = (uint32_t)(i + 1) * SAMPLE_PERIOD;
+    if (sim.now() < next) sim.advance(next - sim.now());
+  }
+
+  Serial.print(p.name); Serial.print(',');
+  Serial.print(name); Serial.print(',');
+  Serial.print(READINGS); Serial.print(',');
+  Serial.print(sim.integrations()); Serial.print(',');
+  Serial.print(latency); Serial.print(',');
+  Serial.print(sim.saturations()); Serial.print(',');
+  Serial.println(100 * errSum / READINGS, 3);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { delay(10); }
+  Serial.println("# Adafruit VEML7700 Auto-Range Simulation");
+
+  Serial.println("profile,policy,readings,integrations,latency_ms,"
+                 "saturations,err_pct");
+  for (uint8_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+    run(profiles[i], "appnote", Adafruit_VEML7700::autoRangeAppNote);
+    run(profiles[i], "sticky", stickyAutoRange);
+  }
+  Serial.println("# done");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,357 @@
+/* VEML7700 Benchmark Example
+ *
+ * This example sketch times the driver's API calls and prints the results
+ * as CSV, one line per call, so runs can be captured from the serial port
+ * and compared before and after a change:
+ *
+ *   name,iterations,total_us,us_per_call,cycles_per_call
+ *
+ * cycles_per_call is read from the DWT cycle counter on Cortex-M3 and up
+ * when it runs, and is derived from micros() and F_CPU elsewhere. QEMU
+ * does not model the counter, CYCCNT reads back 0 there, so the sketch
+ * checks that it advances and falls back to F_CPU if not; the first
+ * comment line says which was used. Lines starting with # are comments,
+ * which include RAM use on AVR.
+ *
+ * The conversion and auto-range math is timed first and needs no sensor,
+ * so the sketch can also be run in an emulator such as simavr. The
+ * simulated sensor stands in for the bus there. Comparing rawToLux_NORMAL
+ * with rawToMilliLux shows what soft-float costs on parts without an FPU.
+ * The computeLux_* lines time what the driver's private computeLux() does
+ * after a read, a multiply by the resolution cached for the current gain
+ * and integration time plus the calibration, without calling it.
+ *
+ * Without a sensor, as under emulation, begin() fails and the driver's
+ * readLux() can not run, so its bus cycles are not measurable there. The
+ * readLux_*_sim lines time the same steps instead, with the simulated
+ * sensor answering the ALS read: an integration at the current settings
+ * (a whole auto-range for AUTO) followed by the lux conversion. They leave
+ * out the driver's register transfers, waits and bookkeeping, and include
+ * the simulated sensor's own light model, so compare them with each other
+ * and across changes rather than with the hardware lines.
+ *
+ * With a sensor attached, the _NOWAIT methods and raw reads measure bus
+ * plus conversion cost only. Subtracting readALS from readLux_NORMAL_NOWAIT
+ * gives the cost of the lux conversion alone, a multiply by the resolution
+ * the driver caches whenever the gain or integration time is set, so no
+ * settings are read back over the bus. The waiting and auto methods
+ * include integration time, so they are run fewer times.
+ */
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Sim.h"
+#include "Adafruit_VEML7700_SwingingDoor.h"
+
+#ifndef F_CPU
+#define F_CPU 0 // unknown, cycles are reported as 0
+#endif
+
+Adafruit_VEML7700 veml = Adafruit_VEML7700();
+Adafruit_VEML7700_Sim sim;
+
+// keeps results live so the compiler can't drop the calls being timed
+volatile float sink;
+// keeps inputs opaque so the compiler can't fold the math being timed
+volatile uint16_t rawInput = 12345;
+
+#if defined(__AVR__)
+extern char *__brkval;
+extern char __heap_start;
+
+int freeRam(void) {
+  char top;
+  return &top - (__brkval ? __brkval : &__heap_start);
+}
+#endif
+
+unsigned long startMicros;
+#if defined(DWT) && defined(CoreDebug)
+uint32_t startCycles;
+bool cycleCounter; // true once CYCCNT has been seen to advance
+#endif
+
+void startTimer(void) {
+#if defined(DWT) && defined(CoreDebug)
+  startCycles = DWT->CYCCNT;
+#endif
+  startMicros = micros();
+}
+
+void report(const char *name, uint16_t iterations) {
+  unsigned long total = micros() - startMicros;
+  float cycles = (float)total / iterations * (F_CPU / 1000000.0);
+#if defined(DWT) && defined(CoreDebug)
+  if (cycleCounter)
+    cycles = (float)(DWT->CYCCNT - startCycles) / iterations;
+#endif
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(iterations);
+  Serial.print(',');
+  Serial.print(total);
+  Serial.print(',');
+  Serial.print((float)total / iterations, 3);
+  Serial.print(',');
+  Serial.println(cycles, 1);
+}
+
+void benchRawToMilliLux(uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = Adafruit_VEML7700::rawToMilliLux(rawInput, VEML7700_GAIN_1_8,
+                                            VEML7700_IT_100MS);
+  }
+  report("rawToMilliLux", iterations);
+}
+
+void benchRawToLux(const char *name, bool corrected, uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = Adafruit_VEML7700::rawToLux(rawInput, VEML7700_GAIN_1_8,
+                                       VEML7700_IT_100MS, corrected);
+  }
+  report(name, iterations);
+}
+
+// per sample cost of converting a buffer at once, to compare with rawToLux
+void benchRawToLuxArray(const char *name, bool corrected, uint16_t batches) {
+  const uint8_t samples = 32;
+  uint16_t raw[samples];
+  float lux[samples];
+  for (uint8_t i = 0; i < samples; i++) {
+    raw[i] = rawInput + i;
+  }
+  startTimer();
+  for (uint16_t i = 0; i < batches; i++) {
+    Adafruit_VEML7700::rawToLux(raw, lux, samples, VEML7700_GAIN_1_8,
+                                VEML7700_IT_100MS, corrected);
+    sink = lux[i % samples];
+  }
+  report(name, batches * samples);
+}
+
+// what computeLux() does with the resolution the driver caches
+void benchComputeLux(const char *name, bool corrected, uint16_t iterations) {
+  veml7700_calibration_t calibration;
+  veml.getCalibration(&calibration);
+  float resolution =
+      Adafruit_VEML7700::resolution(VEML7700_GAIN_1_8, VEML7700_IT_100MS) *
+      calibration.scale;
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    float lux = resolution * rawInput + calibration.offset;
+    if (corrected)
+      lux = veml7700_calibration_correct(&calibration, lux);
+    sink = lux;
+  }
+  report(name, iterations);
+}
+
+void benchResolution(uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = Adafruit_VEML7700::resolution(rawInput & 3, VEML7700_IT_100MS);
+  }
+  report("resolution", iterations);
+}
+
+void benchAutoRangeSim(const char *name, float lux, uint16_t iterations) {
+  sim.setProfile(VEML7700_SIM_CONSTANT, lux);
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    uint8_t gain = VEML7700_GAIN_1_8;
+    uint8_t it = VEML7700_IT_100MS;
+    bool useCorrection;
+    sink = Adafruit_VEML7700::autoRangeAppNote(
+        Adafruit_VEML7700_Sim::integrateCallback, &sim, &gain, &it,
+        &useCorrection);
+  }
+  report(name, iterations);
+}
+
+// One simulated hour at 1 sample per second. The profile is played back
+// twice so the cost of generating it can be taken out of the timing.
+void benchSwingingDoor(const char *name, veml7700_sim_profile_t profile,
+                       float level, float level2, uint32_t period,
+                       float error) {
+  const uint16_t samples = 3600;
+  sim.setProfile(profile, level, level2, period);
+
+  startTimer();
+  for (uint16_t i = 0; i < samples; i++) {
+    sink = sim.lightAt((uint32_t)i * 1000);
+  }
+  unsigned long overhead = micros() - startMicros;
+#if defined(DWT) && defined(CoreDebug)
+  uint32_t overheadCycles = DWT->CYCCNT - startCycles;
+#endif
+
+  Adafruit_VEML7700_SwingingDoor door(error);
+  uint32_t archiveTime;
+  float archiveLux;
+  startTimer();
+  startMicros += overhead;
+#if defined(DWT) && defined(CoreDebug)
+  startCycles += overheadCycles;
+#endif
+  for (uint16_t i = 0; i < samples; i++) {
+    door.add((uint32_t)i * 1000, sim.lightAt((uint32_t)i * 1000),
+             &archiveTime, &archiveLux);
+  }
+  door.flush(&archiveTime, &archiveLux);
+  report(name, samples);
+
+  Serial.print("# ");
+  Serial.print(name);
+  Serial.print(" compression ");
+  Serial.println((float)door.inputs() / door.archived(), 1);
+}
+
+void benchLux(const char *name, luxMethod method, uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = veml.readLux(method);
+  }
+  report(name, iterations);
+}
+
+// the steps of readLux() with the simulated sensor in place of the bus
+void benchLuxSim(const char *name, luxMethod method, uint16_t iterations) {
+  sim.setProfile(VEML7700_SIM_CONSTANT, 500);
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    uint8_t gain = VEML7700_GAIN_1_8;
+    uint8_t it = VEML7700_IT_25MS;
+    bool corrected = (method == VEML_LUX_CORRECTED);
+    uint16_t als;
+    if (method == VEML_LUX_AUTO) {
+      als = Adafruit_VEML7700::autoRangeAppNote(
+          Adafruit_VEML7700_Sim::integrateCallback, &sim, &gain, &it,
+          &corrected);
+    } else {
+      als = sim.integrate(gain, it);
+    }
+    sink = Adafruit_VEML7700::rawToLux(als, gain, it, corrected);
+  }
+  report(name, iterations);
+}
+
+void benchALS(uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = veml.readALS();
+  }
+  report("readALS", iterations);
+}
+
+void benchWhite(uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = veml.readWhite();
+  }
+  report("readWhite", iterations);
+}
+
+void benchGain(uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = veml.getGainValue();
+  }
+  report("getGainValue", iterations);
+}
+
+void benchIntegrationTime(uint16_t iterations) {
+  startTimer();
+  for (uint16_t i = 0; i < iterations; i++) {
+    sink = veml.getIntegrationTimeValue();
+  }
+  report("getIntegrationTimeValue", iterations);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { delay(10); }
+  Serial.println("# Adafruit VEML7700 Benchmark");
+  Serial.print("# F_CPU ");
+  Serial.println((unsigned long)F_CPU);
+
+#if defined(DWT) && defined(CoreDebug)
+  // start the Cortex-M cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  uint32_t cycles = DWT->CYCCNT;
+  delayMicroseconds(10);
+  cycleCounter = (DWT->CYCCNT != cycles);
+  Serial.println(cycleCounter ? "# cycles from DWT CYCCNT"
+                              : "# cycles from F_CPU, CYCCNT not running");
+#else
+  Serial.println("# cycles from F_CPU");
+#endif
+
+  Serial.println("name,iterations,total_us,us_per_call,cycles_per_call");
+  benchRawToLux("rawToLux_NORMAL", false, 1000);
+  benchRawToLux("rawToLux_CORRECTED", true, 1000);
+  benchRawToLuxArray("rawToLuxArray_NORMAL", false, 32);
+  benchRawToLuxArray("rawToLuxArray_CORRECTED", true, 32);
+  benchRawToMilliLux(1000);
+  benchComputeLux("computeLux_NORMAL", false, 1000);
+  benchComputeLux("computeLux_CORRECTED", true, 1000);
+  benchResolution(1000);
+  // dim light walks the whole gain/IT ladder, bright light takes one step
+  benchAutoRangeSim("autoRange_sim_dim", 0.5, 20);
+  benchAutoRangeSim("autoRange_sim_bright", 50000, 20);
+  benchSwingingDoor("swingingDoor_clouds", VEML7700_SIM_CLOUDS, 30000, 0,
+                    20000, 50);
+  benchSwingingDoor("swingingDoor_sunrise", VEML7700_SIM_SUNRISE, 0.01,
+                    50000, 3600000, 1);
+  benchSwingingDoor("swingingDoor_step", VEML7700_SIM_STEP, 5, 20000,
+                    300000, 1);
+
+#if defined(__AVR__)
+  int ramBefore = freeRam();
+#endif
+  bool found = veml.begin();
+#if defined(__AVR__)
+  Serial.print("# begin() heap bytes ");
+  Serial.println(ramBefore - freeRam());
+  Serial.print("# free RAM ");
+  Serial.println(freeRam());
+#endif
+
+  if (!found) {
+    Serial.println("# Sensor not found, timing readLux against the sim");
+    benchLuxSim("readLux_NORMAL_sim", VEML_LUX_NORMAL, 1000);
+    benchLuxSim("readLux_CORRECTED_sim", VEML_LUX_CORRECTED, 1000);
+    benchLuxSim("readLux_AUTO_sim", VEML_LUX_AUTO, 20);
+    Serial.println("# done");
+    return;
+  }
+
+  veml.setGain(VEML7700_GAIN_1_8);
+  veml.setIntegrationTime(VEML7700_IT_25MS);
+
+  benchALS(1000);
+  benchWhite(1000);
+  benchGain(1000);
+  benchIntegrationTime(1000);
+  benchLux("readLux_NORMAL_NOWAIT", VEML_LUX_NORMAL_NOWAIT, 1000);
+  benchLux("readLux_CORRECTED_NOWAIT", VEML_LUX_CORRECTED_NOWAIT, 1000);
+  benchLux("readLux_NORMAL", VEML_LUX_NORMAL, 20);
+  benchLux("readLux_CORRECTED", VEML_LUX_CORRECTED, 20);
+  benchLux("readLux_AUTO", VEML_LUX_AUTO, 5);
+
+  veml7700_energy_stats_t stats;
+  veml.getEnergyStats(&stats);
+  Serial.print("# readings "); Serial.println(stats.readings);
+  Serial.print("# bus transfers "); Serial.println(stats.busTransfers);
+  Serial.print("# bus us "); Serial.println(stats.busMicros);
+  Serial.print("# wait ms "); Serial.println(stats.waitMillis);
+  Serial.print("# sensor uJ "); Serial.println(stats.sensor_uJ, 3);
+  Serial.print("# bus uJ "); Serial.println(stats.bus_uJ, 3);
+  Serial.println("# done");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,68 @@
+/* VEML7700 Host Bridge Example
+ *
+ * This example sketch lets a host program drive the sensor over USB
+ * serial. The host sends a batch of commands in one packet, such as set
+ * the gain and integration time, take a snapshot, then stream a burst of
+ * readings, and the board runs them all before acknowledging, so a whole
+ * sequence costs one round trip. See Adafruit_VEML7700_Bridge.h for the
+ * protocol.
+ *
+ * Drive it from Linux with tools/veml7700_bridge, for example:
+ *
+ *   veml7700_bridge /dev/ttyACM0 config=1/8,25 snapshot burst=200
+ *
+ * tools/veml7700_bridge_sim plays this sketch on a pty with the simulated
+ * sensor, for testing without hardware.
+ */
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Bridge.h"
+
+Adafruit_VEML7700 veml = Adafruit_VEML7700();
+
+bool configure(void *, uint8_t gain, uint8_t it) {
+  veml.setGain(gain);
+  // waits out a cycle, so the next reading uses the new settings
+  veml.setIntegrationTime(it);
+  // read back to catch a sensor that stopped responding
+  return (veml.getGain() == gain) && (veml.getIntegrationTime() == it);
+}
+
+bool measure(void *, veml7700_log_record_t *record) {
+  veml7700_reading_t reading;
+  // waits out the integration time, so bursts run once per measurement
+  if (!veml.getReading(&reading, VEML_LUX_NORMAL))
+    return false;
+  record->timestamp = reading.timestamp;
+  record->als = reading.als;
+  record->white = reading.white;
+  record->gain = reading.gain;
+  record->integrationTime = reading.integrationTime;
+  record->corrected = reading.corrected;
+  return true;
+}
+
+void send(void *, const uint8_t *payload, size_t length) {
+  uint8_t packet[VEML7700_STREAM_PACKET_MAX];
+  size_t n = veml7700_stream_packet(payload, length, packet);
+  Serial.write(packet, n);
+}
+
+Adafruit_VEML7700_Bridge bridge(configure, measure, send);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { delay(10); }
+
+  if (!veml.begin()) {
+    // the host times out waiting for an acknowledgement
+    while (1);
+  }
+}
+
+void loop() {
+  while (Serial.available()) {
+    bridge.push(Serial.read());
+  }
+  bridge.poll();
+}
@@ -0,0 +1,67 @@
+/* VEML7700 Radio Frame Example
+ *
+ * This example sketch packs readings into compact frames sized for a radio
+ * payload, 51 bytes here which is the smallest LoRaWAN maximum. A reading
+ * from the sensor goes in every second as sensor 0, with a simulated
+ * second sensor as sensor 1 to show several sensors sharing a frame. When
+ * a frame is full it is printed in hex where a real node would transmit
+ * it. Pasting the lines into tools/veml7700_framedump decodes them.
+ */
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Frame.h"
+#include "Adafruit_VEML7700_Sim.h"
+
+Adafruit_VEML7700 veml = Adafruit_VEML7700();
+Adafruit_VEML7700_Sim sim;
+
+uint8_t payload[51];
+// 16 bit log lux, 1 bit of sensor id, times in units of 1024ms
+Adafruit_VEML7700_FrameBuilder frame(payload, sizeof(payload),
+                                     VEML7700_FRAME_LUX16, 1, 10);
+
+void send() {
+  size_t length = frame.finish();
+  Serial.print("# ");
+  Serial.print(frame.count());
+  Serial.print(" samples in ");
+  Serial.print(length);
+  Serial.println(" bytes");
+  for (size_t i = 0; i < length; i++) {
+    if (payload[i] < 0x10)
+      Serial.print('0');
+    Serial.print(payload[i], HEX);
+  }
+  Serial.println();
+  frame.reset();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { delay(10); }
+  Serial.println("# Adafruit VEML7700 Radio Frame Test");
+
+  if (!veml.begin()) {
+    Serial.println("# Sensor not found");
+    while (1);
+  }
+  sim.setProfile(VEML7700_SIM_CLOUDS, 20000, 0, 20000);
+}
+
+void loop() {
+  veml7700_reading_t reading;
+  if (veml.getReading(&reading, VEML_LUX_AUTO)) {
+    if (!frame.add(0, &reading)) {
+      send();
+      frame.add(0, &reading);
+    }
+  }
+
+  unsigned long now = millis();
+  if (!frame.addLux(1, now, sim.lightAt(now))) {
+    send();
+    frame.addLux(1, now, sim.lightAt(now));
+  }
+
+  delay(1000);
+}
@@ -0,0 +1,42 @@
+/* VEML7700 Binary Streaming Example
+ *
+ * This example sketch streams every reading to the host as a small binary
+ * packet instead of formatted text, so a burst at the shortest integration
+ * time reaches the host without loss. Each packet is COBS framed with a
+ * CRC and a sequence number, see Adafruit_VEML7700_Stream.h, and takes 16
+ * bytes, well within 115200 baud at 40 readings a second.
+ *
+ * Receive on Linux with tools/veml7700_receive, for example:
+ *
+ *   veml7700_receive /dev/ttyACM0 > capture.csv
+ *
+ * The serial monitor will show garbage, as expected for binary data.
+ */
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Stream.h"
+
+Adafruit_VEML7700 veml = Adafruit_VEML7700();
+Adafruit_VEML7700_StreamWriter stream(&Serial);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { delay(10); }
+
+  // the receiver drops anything before the first packet, so text is fine
+  if (!veml.begin()) {
+    Serial.println("Sensor not found");
+    while (1);
+  }
+
+  veml.setGain(VEML7700_GAIN_1_8);
+  veml.setIntegrationTime(VEML7700_IT_25MS);
+}
+
+void loop() {
+  veml7700_reading_t reading;
+  // waits out the integration time, so this runs once per measurement
+  if (veml.getReading(&reading, VEML_LUX_NORMAL)) {
+    stream.write(&reading);
+  }
+}
@@ -0,0 +1,57 @@
+/* VEML7700 Wait Callback Example
+ *
+ * This example sketch shows how to keep doing useful work while the driver
+ * waits for the sensor to integrate. Every wait in the driver goes through
+ * the callback given to setWaitCallback(), which here keeps blinking an LED
+ * on time instead of stalling for up to 1.6 seconds per reading. The same
+ * hook can put the MCU to sleep instead.
+ */
+
+#include "Adafruit_VEML7700.h"
+
+#ifndef LED_BUILTIN
+#define LED_BUILTIN 13
+#endif
+
+Adafruit_VEML7700 veml = Adafruit_VEML7700();
+
+unsigned long lastBlink = 0;
+
+void blink() {
+  if (millis() - lastBlink >= 100) {
+    lastBlink = millis();
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+}
+
+// must not return until ms have passed
+void busyWait(void *context, unsigned long ms) {
+  (void)context;
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    blink();
+    yield();
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { delay(10); }
+  Serial.println("Adafruit VEML7700 Wait Callback Test");
+
+  pinMode(LED_BUILTIN, OUTPUT);
+  veml.setWaitCallback(busyWait);
+
+  if (!veml.begin()) {
+    Serial.println("Sensor not found");
+    while (1);
+  }
+  Serial.println("Sensor found");
+
+  veml.setIntegrationTime(VEML7700_IT_800MS);
+}
+
+void loop() {
+  // blocks for the integration, but the LED keeps blinking
+  Serial.print("lux: "); Serial.println(veml.readLux());
+}
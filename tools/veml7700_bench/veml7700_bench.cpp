@@ -0,0 +1,186 @@
+/*!
+ *  @file veml7700_bench.cpp
+ *
+ * 	Host benchmark of the driver's conversion and auto-range hot paths,
+ * 	in the CSV style of the veml7700_benchmark example sketch, so runs can
+ * 	be compared before and after a change. The driver runs against the
+ * 	fake register file of veml7700_check, so bus transfers are counted per
+ * 	call and waits cost no real time. In the auto-range runs the simulated
+ * 	sensor answers the ALS reads.
+ *
+ * 	Build and run from this directory with:
+ *
+ * 	  g++ -O2 -I../veml7700_check/shim -I../.. -o veml7700_bench \
+ * 	      veml7700_bench.cpp ../../Adafruit_VEML7700*.cpp && ./veml7700_bench
+ *
+ * 	Prints one line per call:
+ *
+ * 	  name,iterations,total_ns,ns_per_call,reads_per_call,writes_per_call
+ *
+ * 	where reads and writes are register transfers on the bus. Lines
+ * 	starting with # are comments. computeLux() and getResolution() are
+ * 	private, so their cost is reported as the difference between the
+ * 	_NOWAIT lux reads and readALS.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <chrono>
+#include <stdio.h>
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Sim.h"
+
+unsigned long shimMillis = 0;
+uint16_t shimRegisters[8];
+uint16_t (*shimRead)(uint16_t address) = NULL;
+unsigned long shimReads = 0, shimWrites = 0;
+TwoWire Wire;
+
+static Adafruit_VEML7700 veml;
+static Adafruit_VEML7700_Sim sim;
+
+// keeps results live so the compiler can't drop the calls being timed
+static volatile float sink;
+// keeps inputs opaque so the compiler can't fold the math being timed
+static volatile uint16_t rawInput = 12345;
+
+static std::chrono::steady_clock::time_point startTime;
+static unsigned long startReads, startWrites;
+
+// ALS reads integrate the simulated light at the configured settings
+static uint16_t simRead(uint16_t address) {
+  if (address != VEML7700_ALS_DATA)
+    return shimRegisters[address];
+  uint16_t config = shimRegisters[VEML7700_ALS_CONFIG];
+  return sim.integrate((config >> 11) & 0x03, (config >> 6) & 0x0F);
+}
+
+static void startTimer(void) {
+  startReads = shimReads;
+  startWrites = shimWrites;
+  startTime = std::chrono::steady_clock::now();
+}
+
+// returns ns per call, for working out differences
+static double report(const char *name, uint32_t iterations) {
+  double total = std::chrono::duration<double, std::nano>(
+                     std::chrono::steady_clock::now() - startTime)
+                     .count();
+  printf("%s,%lu,%.0f,%.3f,%.2f,%.2f\n", name, (unsigned long)iterations,
+         total, total / iterations,
+         (double)(shimReads - startReads) / iterations,
+         (double)(shimWrites - startWrites) / iterations);
+  return total / iterations;
+}
+
+static void benchRawToLux(const char *name, bool corrected,
+                          uint32_t iterations) {
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = Adafruit_VEML7700::rawToLux(rawInput, VEML7700_GAIN_1_8,
+                                       VEML7700_IT_100MS, corrected);
+  }
+  report(name, iterations);
+}
+
+static void benchRawToMilliLux(uint32_t iterations) {
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = Adafruit_VEML7700::rawToMilliLux(rawInput, VEML7700_GAIN_1_8,
+                                            VEML7700_IT_100MS);
+  }
+  report("rawToMilliLux", iterations);
+}
+
+static void benchResolution(uint32_t iterations) {
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = Adafruit_VEML7700::resolution(rawInput & 3, VEML7700_IT_100MS);
+  }
+  report("resolution", iterations);
+}
+
+static void benchAutoRangeSim(const char *name, float lux,
+                              uint32_t iterations) {
+  sim.setProfile(VEML7700_SIM_CONSTANT, lux);
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    uint8_t gain = VEML7700_GAIN_1_8;
+    uint8_t it = VEML7700_IT_100MS;
+    bool useCorrection;
+    sink = Adafruit_VEML7700::autoRangeAppNote(
+        Adafruit_VEML7700_Sim::integrateCallback, &sim, &gain, &it,
+        &useCorrection);
+  }
+  report(name, iterations);
+}
+
+static double benchLux(const char *name, luxMethod method,
+                       uint32_t iterations) {
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = veml.readLux(method);
+  }
+  return report(name, iterations);
+}
+
+static double benchALS(uint32_t iterations) {
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = veml.readALS();
+  }
+  return report("readALS", iterations);
+}
+
+static void benchGain(uint32_t iterations) {
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = veml.getGainValue();
+  }
+  report("getGainValue", iterations);
+}
+
+// the whole auto-range flow through the driver and the bus
+static void benchAutoLux(const char *name, float lux, uint32_t iterations) {
+  sim.setProfile(VEML7700_SIM_CONSTANT, lux);
+  startTimer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    sink = veml.readLux(VEML_LUX_AUTO);
+  }
+  report(name, iterations);
+}
+
+int main(void) {
+  const uint32_t fast = 10000000, bus = 1000000, slow = 100000;
+
+  printf("# Adafruit VEML7700 host benchmark\n");
+  printf("name,iterations,total_ns,ns_per_call,reads_per_call,"
+         "writes_per_call\n");
+  benchRawToLux("rawToLux_NORMAL", false, fast);
+  benchRawToLux("rawToLux_CORRECTED", true, fast);
+  benchRawToMilliLux(fast);
+  benchResolution(fast);
+  // dim light walks the whole gain/IT ladder, bright light takes one step
+  benchAutoRangeSim("autoRange_sim_dim", 0.5, slow);
+  benchAutoRangeSim("autoRange_sim_bright", 50000, slow);
+
+  // a fixed count, so the lux reads differ from readALS only by the
+  // conversion
+  veml.begin();
+  shimRegisters[VEML7700_ALS_DATA] = rawInput;
+  double als = benchALS(bus);
+  double normal =
+      benchLux("readLux_NORMAL_NOWAIT", VEML_LUX_NORMAL_NOWAIT, bus);
+  double corrected =
+      benchLux("readLux_CORRECTED_NOWAIT", VEML_LUX_CORRECTED_NOWAIT, bus);
+  benchGain(bus);
+
+  shimRead = simRead;
+  benchAutoLux("readLux_AUTO_sim_dim", 0.5, slow);
+  benchAutoLux("readLux_AUTO_sim_bright", 50000, slow);
+
+  printf("# computeLux_NORMAL ns_per_call %.3f\n", normal - als);
+  printf("# computeLux_CORRECTED ns_per_call %.3f\n", corrected - als);
+  return 0;
+}
@@ -0,0 +1,290 @@
+/*!
+ *  @file veml7700_bridge.cpp
+ *
+ * 	Host tool that sends a batch of bridge commands to a board, see
+ * 	Adafruit_VEML7700_Bridge.h, and prints the readings that come back as
+ * 	CSV.
+ *
+ * 	Build from this directory with:
+ *
+ * 	  g++ -O2 -I../.. -o veml7700_bridge veml7700_bridge.cpp \
+ * 	      ../../Adafruit_VEML7700_Bridge.cpp \
+ * 	      ../../Adafruit_VEML7700_Stream.cpp \
+ * 	      ../../Adafruit_VEML7700_Log.cpp ../../Adafruit_VEML7700_Lux.cpp
+ *
+ * 	Usage: veml7700_bridge [-b BAUD] [-t SECONDS] DEVICE COMMAND...
+ *
+ * 	Commands, run on the board in order:
+ *
+ * 	  config=GAIN,MS  gain 1/8, 1/4, 1 or 2 and integration time in ms
+ * 	  snapshot        one reading
+ * 	  burst=COUNT     stream COUNT readings, 0 until Ctrl-C or timeout
+ * 	  stop            end a burst
+ *
+ * 	For example, to set up and take 200 readings in a single round trip:
+ *
+ * 	  veml7700_bridge /dev/ttyACM0 config=1/8,25 snapshot burst=200
+ *
+ * 	DEVICE may also be the pty printed by veml7700_bridge_sim. Gives up
+ * 	after SECONDS without a packet, 5 by default.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Adafruit_VEML7700_Bridge.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void interrupted(int) { stop = 1; }
+
+static speed_t baudRate(long baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 57600:
+    return B57600;
+  case 115200:
+    return B115200;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  case 921600:
+    return B921600;
+  case 1000000:
+    return B1000000;
+  case 2000000:
+    return B2000000;
+  default:
+    return 0;
+  }
+}
+
+static bool parseGain(const char *text, uint8_t *gain) {
+  if (!strcmp(text, "1/8"))
+    *gain = VEML7700_GAIN_1_8;
+  else if (!strcmp(text, "1/4"))
+    *gain = VEML7700_GAIN_1_4;
+  else if (!strcmp(text, "1"))
+    *gain = VEML7700_GAIN_1;
+  else if (!strcmp(text, "2"))
+    *gain = VEML7700_GAIN_2;
+  else
+    return false;
+  return true;
+}
+
+static bool parseIntegrationTime(const char *text, uint8_t *it) {
+  static const uint8_t settings[] = {VEML7700_IT_25MS,  VEML7700_IT_50MS,
+                                     VEML7700_IT_100MS, VEML7700_IT_200MS,
+                                     VEML7700_IT_400MS, VEML7700_IT_800MS};
+  int ms = atoi(text);
+  for (uint8_t i = 0; i < sizeof(settings); i++) {
+    if (veml7700_integration_time_value(settings[i]) == ms) {
+      *it = settings[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool sendBatch(int fd, const uint8_t *batch, size_t length) {
+  uint8_t packet[VEML7700_STREAM_PACKET_MAX + 1];
+  // a leading delimiter drops anything the board saw before
+  packet[0] = 0;
+  size_t n = 1 + veml7700_stream_packet(batch, length, packet + 1);
+  return write(fd, packet, n) == (ssize_t)n;
+}
+
+int main(int argc, char **argv) {
+  long baud = 115200;
+  int timeout = 5;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:t:")) != -1) {
+    switch (opt) {
+    case 'b':
+      baud = atol(optarg);
+      break;
+    case 't':
+      timeout = atoi(optarg);
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-b BAUD] [-t SECONDS] DEVICE COMMAND...\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (optind > argc - 2) {
+    fprintf(stderr, "usage: %s [-b BAUD] [-t SECONDS] DEVICE COMMAND...\n",
+            argv[0]);
+    return 2;
+  }
+
+  // the whole batch goes in one packet
+  uint8_t tag = getpid();
+  uint8_t batch[VEML7700_STREAM_PAYLOAD_MAX] = {VEML7700_BRIDGE_BATCH, tag};
+  size_t length = 2;
+  unsigned long expected = 0;
+  bool unlimited = false;
+  for (int i = optind + 1; i < argc; i++) {
+    const char *command = argv[i];
+    uint8_t args[3];
+    size_t n = 0;
+    char gain[8];
+    int ms;
+    unsigned long count;
+
+    if (!strcmp(command, "snapshot")) {
+      args[n++] = VEML7700_BRIDGE_SNAPSHOT;
+      expected++;
+    } else if (!strcmp(command, "stop")) {
+      args[n++] = VEML7700_BRIDGE_STOP;
+    } else if (sscanf(command, "burst=%lu", &count) == 1) {
+      if (count > 0xFFFF) {
+        fprintf(stderr, "%s: at most 65535 readings\n", command);
+        return 2;
+      }
+      args[n++] = VEML7700_BRIDGE_BURST;
+      args[n++] = count;
+      args[n++] = count >> 8;
+      expected += count;
+      unlimited = unlimited || !count;
+    } else if ((sscanf(command, "config=%7[^,],%d", gain, &ms) == 2) &&
+               parseGain(gain, &args[1]) &&
+               parseIntegrationTime(strchr(command, ',') + 1, &args[2])) {
+      args[n++] = VEML7700_BRIDGE_CONFIGURE;
+      n += 2;
+    } else {
+      fprintf(stderr, "%s: unknown command\n", command);
+      return 2;
+    }
+    if (length + n > sizeof(batch)) {
+      fprintf(stderr, "%s: too many commands for one batch\n", command);
+      return 2;
+    }
+    memcpy(batch + length, args, n);
+    length += n;
+  }
+
+  const char *name = argv[optind];
+  int fd = open(name, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    perror(name);
+    return 1;
+  }
+  if (isatty(fd)) {
+    struct termios tty;
+    speed_t speed = baudRate(baud);
+    if (!speed) {
+      fprintf(stderr, "%s: unsupported baud rate %ld\n", argv[0], baud);
+      return 2;
+    }
+    if (tcgetattr(fd, &tty) < 0) {
+      perror(name);
+      return 1;
+    }
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tty);
+    // drop readings left over from an earlier run
+    tcflush(fd, TCIFLUSH);
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = interrupted;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  if (!sendBatch(fd, batch, length)) {
+    perror(name);
+    return 1;
+  }
+
+  Adafruit_VEML7700_StreamDecoder decoder;
+  unsigned long readings = 0;
+  bool acked = false;
+  uint8_t status = VEML7700_BRIDGE_OK, executed = 0;
+
+  printf("sequence,timestamp,als,white,gain,it,corrected,lux\n");
+  while (!stop && (!acked || unlimited || (readings < expected))) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(fd, &readable);
+    struct timeval wait = {timeout, 0};
+    int ready = select(fd + 1, &readable, NULL, NULL, &wait);
+    if ((ready < 0) && (errno == EINTR))
+      continue;
+    if (ready <= 0) {
+      if (!unlimited)
+        fprintf(stderr, "%s: timed out\n", name);
+      break;
+    }
+
+    uint8_t buffer[4096];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n <= 0)
+      break;
+    for (ssize_t i = 0; i < n; i++) {
+      size_t length = decoder.push(buffer[i]);
+      if (!length)
+        continue;
+
+      uint16_t sequence;
+      veml7700_log_record_t record;
+      uint8_t ackTag;
+      if (veml7700_stream_parse_reading(decoder.payload(), length, &sequence,
+                                        &record)) {
+        printf("%u,%lu,%u,%u,%u,%u,%u,%.4f\n", sequence,
+               (unsigned long)record.timestamp, record.als, record.white,
+               record.gain, record.integrationTime, record.corrected,
+               veml7700_log_lux(&record));
+        readings++;
+      } else if (veml7700_bridge_parse_ack(decoder.payload(), length,
+                                           &ackTag, &status, &executed) &&
+                 (ackTag == tag)) {
+        acked = true;
+        if (status != VEML7700_BRIDGE_OK) {
+          // later commands didn't run, so don't wait for their readings
+          unlimited = false;
+          expected = readings;
+        }
+      }
+    }
+    fflush(stdout);
+  }
+
+  if (unlimited) {
+    uint8_t halt[] = {VEML7700_BRIDGE_BATCH, (uint8_t)(tag + 1),
+                      VEML7700_BRIDGE_STOP};
+    sendBatch(fd, halt, sizeof(halt));
+  }
+  close(fd);
+
+  fprintf(stderr, "readings %lu, crc errors %lu, framing errors %lu\n",
+          readings, (unsigned long)decoder.crcErrors(),
+          (unsigned long)decoder.framingErrors());
+  if (!acked) {
+    fprintf(stderr, "%s: batch was not acknowledged\n", name);
+    return 1;
+  }
+  if (status != VEML7700_BRIDGE_OK) {
+    fprintf(stderr, "%s: command %u failed with status %u\n", name,
+            executed + 1, status);
+    return 1;
+  }
+  return 0;
+}
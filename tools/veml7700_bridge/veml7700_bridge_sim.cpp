@@ -0,0 +1,127 @@
+/*!
+ *  @file veml7700_bridge_sim.cpp
+ *
+ * 	Host tool that plays a board running the bridge, with the simulated
+ * 	sensor in place of the driver, on a pty. Point veml7700_bridge at the
+ * 	pty it prints to test the whole protocol without hardware.
+ *
+ * 	Build from this directory with:
+ *
+ * 	  g++ -O2 -I../.. -o veml7700_bridge_sim veml7700_bridge_sim.cpp \
+ * 	      ../../Adafruit_VEML7700_Bridge.cpp \
+ * 	      ../../Adafruit_VEML7700_Stream.cpp ../../Adafruit_VEML7700_Sim.cpp \
+ * 	      ../../Adafruit_VEML7700_Log.cpp ../../Adafruit_VEML7700_Lux.cpp
+ *
+ * 	Usage: veml7700_bridge_sim [LUX]
+ *
+ * 	The simulated light is clouds passing over LUX, 1000 by default. The
+ * 	simulator runs on a virtual clock, so bursts stream as fast as the pty
+ * 	takes them.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Adafruit_VEML7700_Bridge.h"
+#include "Adafruit_VEML7700_Sim.h"
+
+struct Device {
+  Adafruit_VEML7700_Sim sim;
+  uint8_t gain, it;
+  int fd;
+};
+
+static bool configure(void *context, uint8_t gain, uint8_t it) {
+  Device *device = (Device *)context;
+  device->gain = gain;
+  device->it = it;
+  return true;
+}
+
+static bool measure(void *context, veml7700_log_record_t *record) {
+  Device *device = (Device *)context;
+  record->als = device->sim.integrate(device->gain, device->it);
+  // the simulator models the ALS channel only
+  record->white = record->als;
+  record->timestamp = device->sim.now();
+  record->gain = device->gain;
+  record->integrationTime = device->it;
+  record->corrected = false;
+  return true;
+}
+
+static void send(void *context, const uint8_t *payload, size_t length) {
+  Device *device = (Device *)context;
+  uint8_t packet[VEML7700_STREAM_PACKET_MAX];
+  size_t n = veml7700_stream_packet(payload, length, packet);
+  for (size_t done = 0; done < n;) {
+    ssize_t written = write(device->fd, packet + done, n - done);
+    if (written <= 0) {
+      perror("write");
+      exit(1);
+    }
+    done += written;
+  }
+}
+
+int main(int argc, char **argv) {
+  float lux = (argc > 1) ? atof(argv[1]) : 1000;
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((master < 0) || (grantpt(master) < 0) || (unlockpt(master) < 0)) {
+    perror("pty");
+    return 1;
+  }
+
+  // hold the other side open and raw, so hosts can come and go
+  const char *name = ptsname(master);
+  int slave = open(name, O_RDWR | O_NOCTTY);
+  struct termios tty;
+  if ((slave < 0) || (tcgetattr(slave, &tty) < 0)) {
+    perror(name);
+    return 1;
+  }
+  cfmakeraw(&tty);
+  tcsetattr(slave, TCSANOW, &tty);
+
+  Device device;
+  device.sim.setProfile(VEML7700_SIM_CLOUDS, lux, 0, 20000);
+  device.gain = VEML7700_GAIN_1;
+  device.it = VEML7700_IT_100MS;
+  device.fd = master;
+  Adafruit_VEML7700_Bridge bridge(configure, measure, send, &device);
+
+  printf("%s\n", name);
+  fflush(stdout);
+
+  while (true) {
+    // don't block on the host while a burst is streaming
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(master, &readable);
+    struct timeval none = {0, 0};
+    if (select(master + 1, &readable, NULL, NULL,
+               bridge.bursting() ? &none : NULL) < 0) {
+      perror("select");
+      return 1;
+    }
+
+    if (FD_ISSET(master, &readable)) {
+      uint8_t buffer[256];
+      ssize_t n = read(master, buffer, sizeof(buffer));
+      if (n <= 0) {
+        perror("read");
+        return 1;
+      }
+      for (ssize_t i = 0; i < n; i++)
+        bridge.push(buffer[i]);
+    }
+    bridge.poll();
+  }
+}
@@ -0,0 +1,21 @@
+/*!
+ *  @file Adafruit_I2CDevice.h
+ *
+ * 	Placeholder device for veml7700_check
+ *
+ * 	BSD (see license.txt)
+ */
+
+#ifndef _VEML7700_CHECK_I2CDEVICE_H
+#define _VEML7700_CHECK_I2CDEVICE_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+class Adafruit_I2CDevice {
+public:
+  Adafruit_I2CDevice(uint8_t, TwoWire *) {}
+  bool begin(void) { return true; }
+};
+
+#endif
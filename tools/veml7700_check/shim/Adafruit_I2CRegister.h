@@ -0,0 +1,58 @@
+/*!
+ *  @file Adafruit_I2CRegister.h
+ *
+ * 	Registers of a fake VEML7700 for the host tools. Writes land in
+ * 	shimRegisters, so settings read back, and tests set the data registers
+ * 	directly or through shimRead. Every transfer is counted.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#ifndef _VEML7700_CHECK_I2CREGISTER_H
+#define _VEML7700_CHECK_I2CREGISTER_H
+
+#include "Adafruit_I2CDevice.h"
+
+extern uint16_t shimRegisters[8]; ///< Register file, by address
+/// If set, called for every register read in place of the register file
+extern uint16_t (*shimRead)(uint16_t address);
+extern unsigned long shimReads;  ///< Register reads so far
+extern unsigned long shimWrites; ///< Register writes so far
+
+class Adafruit_I2CRegister {
+public:
+  Adafruit_I2CRegister(Adafruit_I2CDevice *, uint16_t address, uint8_t = 1,
+                       uint8_t = 0)
+      : _address(address) {}
+  bool write(uint32_t value, uint8_t = 0) {
+    shimWrites++;
+    shimRegisters[_address] = value;
+    return true;
+  }
+  uint32_t read(void) {
+    shimReads++;
+    return shimRead ? shimRead(_address) : shimRegisters[_address];
+  }
+
+private:
+  uint16_t _address;
+};
+
+class Adafruit_I2CRegisterBits {
+public:
+  Adafruit_I2CRegisterBits(Adafruit_I2CRegister *reg, uint8_t bits,
+                           uint8_t shift)
+      : _reg(reg), _mask((1 << bits) - 1), _shift(shift) {}
+  bool write(uint32_t value) {
+    uint32_t all = _reg->read() & ~(_mask << _shift);
+    return _reg->write(all | ((value & _mask) << _shift));
+  }
+  uint32_t read(void) { return (_reg->read() >> _shift) & _mask; }
+
+private:
+  Adafruit_I2CRegister *_reg;
+  uint32_t _mask;
+  uint8_t _shift;
+};
+
+#endif
@@ -0,0 +1,26 @@
+/*!
+ *  @file Arduino.h
+ *
+ * 	Just enough of the Arduino core to build the driver on a host for
+ * 	veml7700_check, with a virtual clock that only delay() advances
+ *
+ * 	BSD (see license.txt)
+ */
+
+#ifndef _VEML7700_CHECK_ARDUINO_H
+#define _VEML7700_CHECK_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LSBFIRST 0 ///< Byte order of the sensor's registers
+
+extern unsigned long shimMillis; ///< Virtual time in ms
+
+inline unsigned long millis(void) { return shimMillis; }
+inline unsigned long micros(void) { return shimMillis * 1000; }
+inline void delay(unsigned long ms) { shimMillis += ms; }
+
+#endif
@@ -0,0 +1,15 @@
+/*!
+ *  @file Wire.h
+ *
+ * 	Placeholder bus for veml7700_check
+ *
+ * 	BSD (see license.txt)
+ */
+
+#ifndef _VEML7700_CHECK_WIRE_H
+#define _VEML7700_CHECK_WIRE_H
+
+class TwoWire {};
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,318 @@
+/*!
+ *  @file veml7700_check.cpp
+ *
+ * 	Host checks of the library's numerics and of the driver against a fake
+ * 	sensor. The headers in shim/ stand in for the Arduino core and bus
+ * 	libraries.
+ *
+ * 	Build and run from this directory with:
+ *
+ * 	  g++ -O2 -Ishim -I../.. -o veml7700_check veml7700_check.cpp \
+ * 	      ../../Adafruit_VEML7700*.cpp && ./veml7700_check
+ *
+ * 	Build it a second time with -march=haswell added, or -mfma, so the
+ * 	bit for bit checks also run with fused multiply-adds available, as on
+ * 	Cortex-M4F and M7 parts. With clang, use clang++ in place of g++.
+ *
+ * 	Prints one line per check and exits non-zero if any failed.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Adafruit_VEML7700.h"
+#include "Adafruit_VEML7700_Accumulator.h"
+#include "Adafruit_VEML7700_Calibration.h"
+#include "Adafruit_VEML7700_Deadband.h"
+#include "Adafruit_VEML7700_HDR.h"
+#include "Adafruit_VEML7700_Integral.h"
+#include "Adafruit_VEML7700_Stats.h"
+
+static const uint8_t gains[] = {VEML7700_GAIN_1_8, VEML7700_GAIN_1_4,
+                                VEML7700_GAIN_1, VEML7700_GAIN_2};
+static const uint8_t intTimes[] = {VEML7700_IT_25MS,  VEML7700_IT_50MS,
+                                   VEML7700_IT_100MS, VEML7700_IT_200MS,
+                                   VEML7700_IT_400MS, VEML7700_IT_800MS};
+
+unsigned long shimMillis = 0;
+uint16_t shimRegisters[8];
+uint16_t (*shimRead)(uint16_t address) = NULL;
+unsigned long shimReads = 0, shimWrites = 0;
+TwoWire Wire;
+
+static int failures = 0;
+
+static void check(bool ok, const char *name) {
+  printf("%s %s\n", ok ? "ok  " : "FAIL", name);
+  if (!ok)
+    failures++;
+}
+
+static bool within(double value, double expected, double tolerance) {
+  return fabs(value - expected) <= tolerance * fabs(expected) + 1e-12;
+}
+
+// A sliding window that sees a day of bright light then night must report
+// the night exactly, not the rounding left by removing the day.
+static void checkStatsDayNight(void) {
+  const uint16_t size = 60;
+  float values[size];
+  uint16_t minQueue[size], maxQueue[size];
+  Adafruit_VEML7700_Stats stats(values, minQueue, maxQueue, size);
+
+  srand(1);
+  for (uint32_t i = 0; i < 100000; i++)
+    stats.add(80000 + (rand() % 20001) - 10000.0f);
+  float night[size];
+  for (uint16_t i = 0; i < 3 * size + 17; i++) {
+    float lux = 1 + (rand() % 1001) / 10000.0f - 0.05f;
+    night[i % size] = lux;
+    stats.add(lux);
+  }
+
+  // two pass over the same window
+  double sum = 0, m2 = 0;
+  for (uint16_t i = 0; i < size; i++)
+    sum += night[i];
+  double mean = sum / size;
+  for (uint16_t i = 0; i < size; i++)
+    m2 += (night[i] - mean) * (night[i] - mean);
+  double variance = m2 / (size - 1);
+
+  check(within(stats.mean(), mean, 1e-5), "stats: mean after day then night");
+  check(within(stats.variance(), variance, 1e-3),
+        "stats: variance after day then night");
+}
+
+// Between wraparounds too: every window from the last day value leaving to
+// the next wraparound must match a two pass over the same night values.
+static void checkStatsMidTransition(void) {
+  const uint16_t size = 60;
+  float values[size];
+  uint16_t minQueue[size], maxQueue[size];
+  Adafruit_VEML7700_Stats stats(values, minQueue, maxQueue, size);
+
+  srand(2);
+  for (uint32_t i = 0; i < 100000; i++)
+    stats.add(80000 + (rand() % 20001) - 10000.0f);
+  float night[2 * size];
+  double worstMean = 0, worstVariance = 0;
+  for (uint16_t i = 0; i < 2 * size; i++) {
+    night[i] = 1 + (rand() % 1001) / 10000.0f - 0.05f;
+    stats.add(night[i]);
+    if (i + 1 < size)
+      continue;
+
+    double sum = 0, m2 = 0;
+    for (uint16_t j = i + 1 - size; j <= i; j++)
+      sum += night[j];
+    double mean = sum / size;
+    for (uint16_t j = i + 1 - size; j <= i; j++)
+      m2 += (night[j] - mean) * (night[j] - mean);
+    double variance = m2 / (size - 1);
+    if (fabs(stats.mean() - mean) > worstMean)
+      worstMean = fabs(stats.mean() - mean);
+    if (fabs(stats.variance() - variance) / variance > worstVariance)
+      worstVariance = fabs(stats.variance() - variance) / variance;
+  }
+
+  check(worstMean < 1e-5, "stats: mean mid transition");
+  check(worstVariance < 1e-4, "stats: variance mid transition");
+}
+
+// The default calibration must give the same bits as the conversion the
+// host tools use, on every count and setting. Build this with -mfma (or
+// -march=haswell) too, since fused multiply-adds are what would break it.
+static void checkCalibrationMatchesLux(void) {
+  veml7700_calibration_t calibration;
+  veml7700_calibration_default(&calibration);
+  uint32_t mismatches = 0;
+
+  for (uint8_t g = 0; g < sizeof(gains); g++) {
+    for (uint8_t t = 0; t < sizeof(intTimes); t++) {
+      float resolution = veml7700_resolution(gains[g], intTimes[t]);
+      for (uint32_t raw = 0; raw <= 0xFFFF; raw++) {
+        float lux = veml7700_calibration_correct(&calibration,
+                                                 resolution * (uint16_t)raw);
+        if (lux != veml7700_raw_to_lux(raw, gains[g], intTimes[t], true))
+          mismatches++;
+      }
+    }
+  }
+  if (mismatches)
+    printf("     %lu mismatches\n", (unsigned long)mismatches);
+  check(!mismatches, "calibration: default matches veml7700_raw_to_lux");
+}
+
+// Both HDR exposures must carry the sensor's calibration, or the fused
+// stream steps at the handover between them.
+static void checkHDRCalibrated(void) {
+  Adafruit_VEML7700 veml;
+  veml.begin();
+  veml7700_calibration_t calibration;
+  veml7700_calibration_default(&calibration);
+  calibration.scale = 1.1;
+  calibration.offset = 0.25;
+  veml.setCalibration(&calibration);
+  Adafruit_VEML7700_HDR hdr(&veml);
+
+  // the fake sensor gives both exposures the same count, so a count over
+  // the linear limit hands over to the range exposure and one under it
+  // back to the sensitive one
+  const uint16_t counts[] = {20000, 500};
+  for (uint8_t i = 0; i < 2; i++) {
+    shimRegisters[VEML7700_ALS_DATA] = counts[i];
+    veml7700_reading_t reading;
+    bool done = false;
+    for (uint16_t ms = 0; (ms < 5000) && !done; ms++) {
+      shimMillis++;
+      // the first reading after a change may come from either exposure
+      done = hdr.update(&reading) && (hdr.sensitive() == (i == 1));
+    }
+
+    float linear = calibration.scale *
+                       veml7700_resolution(reading.gain,
+                                           reading.integrationTime) *
+                       counts[i] +
+                   calibration.offset;
+    float expected = reading.corrected
+                         ? veml7700_calibration_correct(&calibration, linear)
+                         : linear;
+    check(done && (reading.corrected == (i == 0)) &&
+              within(reading.lux, expected, 1e-6),
+          i ? "hdr: sensitive exposure is calibrated"
+            : "hdr: range exposure is calibrated");
+  }
+}
+
+// The accumulator's mean and standard error must carry the sensor's
+// calibration, like every other reading from it.
+static void checkAccumulatorCalibrated(void) {
+  Adafruit_VEML7700 veml;
+  veml.begin();
+  veml.setGain(VEML7700_GAIN_2);
+  veml.setIntegrationTime(VEML7700_IT_800MS, false);
+  veml7700_calibration_t calibration;
+  veml7700_calibration_default(&calibration);
+  calibration.scale = 1.1;
+  calibration.offset = 0.25;
+  veml.setCalibration(&calibration);
+  shimRegisters[VEML7700_ALS_DATA] = 3;
+  Adafruit_VEML7700_Accumulator accumulator(&veml, 16);
+
+  veml7700_accumulation_t result;
+  bool done = false;
+  for (uint32_t ms = 0; (ms < 60000) && !done; ms++) {
+    shimMillis++;
+    done = accumulator.update(&result);
+  }
+  float resolution = calibration.scale *
+                     veml7700_resolution(VEML7700_GAIN_2, VEML7700_IT_800MS);
+  // every count the same, so only quantization is left in the error
+  check(done && within(result.lux, 3 * resolution + calibration.offset, 1e-6) &&
+            within(result.uncertainty, resolution * sqrt(1.0 / 12 / 16),
+                   1e-6),
+        "accumulator: mean and error are calibrated");
+}
+
+// The accumulator reads every other integration, so a result of N counts
+// takes 2 x N integration times, as its documentation says.
+static void checkAccumulatorPeriod(void) {
+  Adafruit_VEML7700 veml;
+  veml.begin();
+  veml.setGain(VEML7700_GAIN_2);
+  veml.setIntegrationTime(VEML7700_IT_800MS, false);
+  shimRegisters[VEML7700_ALS_DATA] = 3;
+  Adafruit_VEML7700_Accumulator accumulator(&veml, 16);
+
+  unsigned long start = shimMillis;
+  veml7700_accumulation_t result;
+  bool done = false;
+  while (!done && (shimMillis - start < 60000)) {
+    shimMillis++;
+    done = accumulator.update(&result);
+  }
+  check(done && (shimMillis - start == 16 * 2 * 800) && (result.sum == 48),
+        "accumulator: 16 counts at 800ms take 25.6 s");
+}
+
+// An auto-ranged reading is one reading for the energy counters, however
+// many integrations it took, and its settings writes are bus transfers.
+static void checkEnergyAutoReading(void) {
+  Adafruit_VEML7700 veml;
+  veml.begin();
+  // dim enough that the App Note flow steps through several settings
+  shimRegisters[VEML7700_ALS_DATA] = 50;
+  unsigned long reads = shimReads, writes = shimWrites;
+  shimMillis += 1000;
+  veml.readLux(VEML_LUX_AUTO);
+  unsigned long transfers = (shimReads - reads) + (shimWrites - writes);
+
+  veml7700_energy_stats_t stats;
+  veml.getEnergyStats(&stats);
+  check(stats.readings == 1, "energy: auto reading counts once");
+  check(stats.busTransfers == transfers,
+        "energy: settings writes are bus transfers");
+  check(within(veml.getReadingEnergy(), veml.getEnergy(), 1e-6) &&
+            (veml.getReadingEnergy() > 0),
+        "energy: auto reading carries all of its integrations");
+}
+
+// A negative calibrated lux must still have a band around it, not pass
+// every small change on.
+static void checkDeadbandNegative(void) {
+  Adafruit_VEML7700_Deadband deadband(0.1, 0, 0);
+
+  bool first = deadband.check(-100, 0);
+  bool inside = deadband.check(-95, 1);
+  bool outside = deadband.check(-111, 2);
+  check(first && !inside && outside, "deadband: band around negative lux");
+}
+
+// Integer and double literals must pick the lux overload, and millilux
+// must be asked for by name.
+static void checkIntegralOverloads(void) {
+  Adafruit_VEML7700_Integral lux(0), millilux(0);
+
+  lux.add(500, 0);
+  lux.add(12.5, 3600000);
+  millilux.addMilliLux(500000, 0);
+  millilux.addMilliLux(12500, 3600000);
+  check(within(lux.luxHours(), 256.25, 1e-6) &&
+            (lux.luxHours() == millilux.luxHours()),
+        "integral: literals add lux");
+}
+
+// Days set to have begun well before the last reading must not close days
+// between it and the next one.
+static void checkIntegralLateSetDay(void) {
+  const uint32_t start = 4 * VEML7700_DAY_MS;
+  Adafruit_VEML7700_Integral integral(0);
+
+  integral.add(100, start);
+  integral.add(100, start + 3600000);
+  integral.setDay(start - 3 * VEML7700_DAY_MS + 60000);
+  integral.add(100, start + 7200000);
+  check((integral.days() == 0) && within(integral.luxHours(), 200, 1e-6),
+        "integral: setDay() in the past closes no days");
+}
+
+int main(void) {
+  checkStatsDayNight();
+  checkStatsMidTransition();
+  checkCalibrationMatchesLux();
+  checkHDRCalibrated();
+  checkAccumulatorCalibrated();
+  checkAccumulatorPeriod();
+  checkEnergyAutoReading();
+  checkDeadbandNegative();
+  checkIntegralOverloads();
+  checkIntegralLateSetDay();
+
+  if (failures)
+    printf("%d failed\n", failures);
+  return failures ? 1 : 0;
+}
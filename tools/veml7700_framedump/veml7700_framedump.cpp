@@ -0,0 +1,153 @@
+/*!
+ *  @file veml7700_framedump.cpp
+ *
+ * 	Host tool that decodes VEML7700 radio frames and prints their samples
+ * 	as CSV.
+ *
+ * 	Build from this directory with:
+ *
+ * 	  g++ -O2 -I../.. -o veml7700_framedump veml7700_framedump.cpp \
+ * 	      ../../Adafruit_VEML7700_Frame.cpp ../../Adafruit_VEML7700_Log.cpp \
+ * 	      ../../Adafruit_VEML7700_Lux.cpp ../../Adafruit_VEML7700_LuxCode.cpp
+ *
+ * 	Usage: veml7700_framedump [FILE...]
+ * 	       veml7700_framedump -b FRAMEFILE...
+ *
+ * 	By default each line of the files, or of standard input, holds one
+ * 	frame in hex, as network servers and serial gateways usually show
+ * 	payloads. Spaces are ignored, as are blank lines and lines starting
+ * 	with #. With -b each file holds one binary frame.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Adafruit_VEML7700_Frame.h"
+
+static unsigned long frames = 0;
+static int status = 0;
+
+static void dump(const uint8_t *data, size_t length, const char *where) {
+  Adafruit_VEML7700_FrameReader reader(data, length);
+  veml7700_frame_sample_t sample;
+  unsigned decoded = 0;
+
+  while (reader.next(&sample)) {
+    const veml7700_log_record_t &r = sample.record;
+    printf("%lu,%u,%lu,", frames, sample.sensor, (unsigned long)r.timestamp);
+    if (reader.mode() == VEML7700_FRAME_RAW)
+      printf("%u,%u,%u,%u,%u,", r.als, r.white, r.gain, r.integrationTime,
+             r.corrected);
+    else
+      printf(",,,,,");
+    printf("%.4f\n", sample.lux);
+    decoded++;
+  }
+  if (reader.error() || (decoded != reader.count())) {
+    fprintf(stderr, "%s: malformed frame after %u samples\n", where, decoded);
+    status = 1;
+  }
+  frames++;
+}
+
+static int hexValue(int c) {
+  if (isdigit(c))
+    return c - '0';
+  c = tolower(c);
+  if ((c >= 'a') && (c <= 'f'))
+    return c - 'a' + 10;
+  return -1;
+}
+
+static void dumpHex(FILE *f, const char *name) {
+  char line[2048];
+  uint8_t frame[sizeof(line) / 2];
+  unsigned long number = 0;
+
+  while (fgets(line, sizeof(line), f)) {
+    number++;
+    size_t length = 0;
+    int high = -1;
+    bool bad = false;
+    if (line[0] == '#')
+      continue;
+    for (char *p = line; *p; p++) {
+      if (isspace((unsigned char)*p))
+        continue;
+      int v = hexValue((unsigned char)*p);
+      if (v < 0) {
+        bad = true;
+        break;
+      }
+      if (high < 0) {
+        high = v;
+      } else {
+        frame[length++] = (high << 4) | v;
+        high = -1;
+      }
+    }
+    char where[512];
+    snprintf(where, sizeof(where), "%s:%lu", name, number);
+    if (bad || (high >= 0)) {
+      fprintf(stderr, "%s: not a hex frame\n", where);
+      status = 1;
+      continue;
+    }
+    if (length)
+      dump(frame, length, where);
+  }
+}
+
+static void dumpBinary(const char *name) {
+  uint8_t frame[4096];
+  FILE *f = fopen(name, "rb");
+  if (!f) {
+    perror(name);
+    status = 1;
+    return;
+  }
+  size_t length = fread(frame, 1, sizeof(frame), f);
+  fclose(f);
+  dump(frame, length, name);
+}
+
+int main(int argc, char **argv) {
+  bool binary = false;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b")) != -1) {
+    if (opt != 'b') {
+      fprintf(stderr, "usage: %s [-b] [FILE...]\n", argv[0]);
+      return 2;
+    }
+    binary = true;
+  }
+
+  printf("frame,sensor,timestamp,als,white,gain,it,corrected,lux\n");
+  if (optind == argc) {
+    if (binary) {
+      fprintf(stderr, "%s: -b needs frame files\n", argv[0]);
+      return 2;
+    }
+    dumpHex(stdin, "stdin");
+  }
+  for (int i = optind; i < argc; i++) {
+    if (binary) {
+      dumpBinary(argv[i]);
+      continue;
+    }
+    FILE *f = fopen(argv[i], "r");
+    if (!f) {
+      perror(argv[i]);
+      status = 1;
+      continue;
+    }
+    dumpHex(f, argv[i]);
+    fclose(f);
+  }
+  return status;
+}
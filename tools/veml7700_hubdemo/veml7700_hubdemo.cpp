@@ -0,0 +1,196 @@
+/*!
+ *  @file veml7700_hubdemo.cpp
+ *
+ * 	Host demo of Adafruit_VEML7700_Hub shared between processes. The slots
+ * 	live in a shared memory mapping. A forked writer process publishes
+ * 	readings into every slot as fast as it can, while the parent reads
+ * 	them back, checks every accepted copy for tearing and measures read
+ * 	throughput. Each published reading is built from a single counter, so
+ * 	a copy mixing two publishes is caught. The same copy taken without the
+ * 	seqlock is checked too, to show that tearing does happen. Finally the
+ * 	writer is killed, possibly mid update, and every slot is read with a
+ * 	bounded number of tries, so a dead writer can not hang a reader.
+ *
+ * 	The hub needs neither Arduino nor the driver on a host. Build and run
+ * 	from this directory with:
+ *
+ * 	  g++ -O2 -I../.. -o veml7700_hubdemo veml7700_hubdemo.cpp \
+ * 	      ../../Adafruit_VEML7700_Hub.cpp && ./veml7700_hubdemo
+ *
+ * 	Usage: veml7700_hubdemo [-n SLOTS] [-s SECONDS]
+ *
+ * 	Prints a summary and exits non-zero if a torn reading was accepted.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <chrono>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Adafruit_VEML7700_Hub.h"
+
+// every field follows from the timestamp
+static void fill(uint32_t n, veml7700_reading_t *reading) {
+  reading->timestamp = n;
+  reading->als = n;
+  reading->white = n >> 16;
+  reading->gain = n & 0x03;
+  reading->integrationTime = n & 0x0F;
+  reading->corrected = n & 0x10;
+  reading->lux = n & 0xFFFFFF;
+}
+
+static bool torn(const veml7700_reading_t *reading) {
+  veml7700_reading_t expected;
+  fill(reading->timestamp, &expected);
+  return (reading->als != expected.als) ||
+         (reading->white != expected.white) ||
+         (reading->gain != expected.gain) ||
+         (reading->integrationTime != expected.integrationTime) ||
+         (reading->corrected != expected.corrected) ||
+         (reading->lux != expected.lux);
+}
+
+static void writer(Adafruit_VEML7700_Hub *hub) {
+  veml7700_reading_t reading;
+  for (uint32_t n = 1;; n++) {
+    fill(n, &reading);
+    hub->publish(n % hub->count(), &reading);
+  }
+}
+
+// read every slot for about seconds, returning slot reads done
+static uint64_t reader(const Adafruit_VEML7700_Hub *hub, double seconds,
+                       uint64_t *accepted, uint64_t *tornAccepted) {
+  veml7700_reading_t reading;
+  uint64_t reads = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto stop = start + std::chrono::duration<double>(seconds);
+
+  while (std::chrono::steady_clock::now() < stop) {
+    for (uint16_t i = 0; i < hub->count(); i++) {
+      if (hub->tryRead(i, &reading)) {
+        (*accepted)++;
+        if (torn(&reading))
+          (*tornAccepted)++;
+      }
+    }
+    reads += hub->count();
+  }
+  return reads;
+}
+
+// the same copies without the seqlock, returning torn copies seen
+static uint64_t unguarded(const veml7700_hub_slot_t *slots, uint16_t count,
+                          double seconds, uint64_t *copies) {
+  veml7700_reading_t reading;
+  uint64_t tornCopies = 0;
+  auto stop = std::chrono::steady_clock::now() +
+              std::chrono::duration<double>(seconds);
+
+  while (std::chrono::steady_clock::now() < stop) {
+    for (uint16_t i = 0; i < count; i++) {
+      memcpy(&reading, (const void *)&slots[i].reading, sizeof(reading));
+      if (torn(&reading))
+        tornCopies++;
+    }
+    *copies += count;
+  }
+  return tornCopies;
+}
+
+int main(int argc, char **argv) {
+  unsigned slots = 256;
+  double seconds = 2;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+    switch (opt) {
+    case 'n':
+      slots = atoi(optarg);
+      break;
+    case 's':
+      seconds = atof(optarg);
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-n SLOTS] [-s SECONDS]\n", argv[0]);
+      return 2;
+    }
+  }
+  if ((slots < 1) || (slots > 0xFFFF) || !(seconds > 0)) {
+    fprintf(stderr, "usage: %s [-n SLOTS] [-s SECONDS]\n", argv[0]);
+    return 2;
+  }
+
+  size_t size = slots * sizeof(veml7700_hub_slot_t);
+  void *map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  veml7700_hub_slot_t *shared = (veml7700_hub_slot_t *)map;
+  Adafruit_VEML7700_Hub hub(shared, slots);
+  hub.clear();
+
+  // uncontended first, then against the writer
+  veml7700_reading_t reading;
+  for (uint16_t i = 0; i < slots; i++) {
+    fill(i + 1, &reading);
+    hub.publish(i, &reading);
+  }
+  uint64_t idleAccepted = 0, idleTorn = 0;
+  auto start = std::chrono::steady_clock::now();
+  uint64_t idleReads = reader(&hub, seconds / 2, &idleAccepted, &idleTorn);
+  double idleSeconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    return 1;
+  }
+  if (pid == 0) {
+    // each process builds its own hub over the shared slots
+    Adafruit_VEML7700_Hub own(shared, slots);
+    writer(&own);
+  }
+
+  uint64_t accepted = 0, tornAccepted = 0, copies = 0;
+  start = std::chrono::steady_clock::now();
+  uint64_t reads = reader(&hub, seconds, &accepted, &tornAccepted);
+  double busySeconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  uint64_t tornCopies = unguarded(shared, slots, seconds / 2, &copies);
+
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+  unsigned stuck = 0;
+  for (uint16_t i = 0; i < slots; i++) {
+    if (!hub.read(i, &reading, 1000))
+      stuck++;
+    else if (torn(&reading))
+      tornAccepted++;
+  }
+  munmap(map, size);
+
+  tornAccepted += idleTorn;
+  printf("slots,%u\n", slots);
+  printf("idle_reads_per_us,%.1f\n", idleReads / idleSeconds / 1e6);
+  printf("busy_reads_per_us,%.1f\n", reads / busySeconds / 1e6);
+  printf("busy_accepted,%llu\n", (unsigned long long)accepted);
+  printf("busy_retries,%llu\n", (unsigned long long)(reads - accepted));
+  printf("torn_accepted,%llu\n", (unsigned long long)tornAccepted);
+  printf("unguarded_copies,%llu\n", (unsigned long long)copies);
+  printf("unguarded_torn,%llu\n", (unsigned long long)tornCopies);
+  printf("slots_left_mid_update,%u\n", stuck);
+  return tornAccepted ? 1 : 0;
+}
@@ -0,0 +1,328 @@
+/*!
+ *  @file veml7700_logconvert.cpp
+ *
+ * 	Host tool that converts large VEML7700 binary logs to lux in bulk. The
+ * 	log is memory mapped and decoded in place, split across all cores,
+ * 	using the library's own conversion math so the results match the
+ * 	device bit for bit.
+ *
+ * 	Build from this directory with:
+ *
+ * 	  g++ -O2 -pthread -I../.. -o veml7700_logconvert \
+ * 	      veml7700_logconvert.cpp ../../Adafruit_VEML7700_Log.cpp \
+ * 	      ../../Adafruit_VEML7700_Lux.cpp
+ *
+ * 	Usage: veml7700_logconvert [-j THREADS] [-o OUTFILE] LOGFILE
+ *
+ * 	Prints a summary. With -o, also writes one little endian record per
+ * 	reading, a uint32 timestamp in ms followed by a float32 lux, in log
+ * 	order.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "Adafruit_VEML7700_Log.h"
+
+// The log is split into byte ranges of CHUNK_BYTES. Records are variable
+// length and delta timed, so each range first finds its own way into the
+// record stream, then is decoded with times relative to its start until a
+// short serial pass over the ranges fixes their start times.
+static const size_t CHUNK_BYTES = 1 << 20;
+
+// More threads than this only add overhead, the work is split by chunk
+static const unsigned MAX_THREADS = 256;
+
+struct Summary {
+  uint64_t count = 0;
+  double sum = 0;
+  float min = FLT_MAX;
+  float max = -FLT_MAX;
+};
+
+struct Chunk {
+  size_t offset;    // byte offset of the first record
+  size_t end;       // byte offset past the last record
+  size_t stop;      // byte offset where decoding stopped
+  uint64_t first;   // index of the first reading
+  uint32_t time;    // time before the first record
+  uint32_t endTime; // time of the last record, relative unless synced
+  bool synced;      // a time record set the absolute time
+  Summary summary;  // readings decoded
+};
+
+struct OutputRecord {
+  uint32_t timestamp;
+  float lux;
+};
+
+// Run work(i) for every i below n on up to threads threads
+template <typename Work>
+static void parallel(unsigned threads, size_t n, Work work) {
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      size_t i;
+      while ((i = next++) < n)
+        work(i);
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+}
+
+// Find a record boundary in [begin, end) without decoding from the start
+// of the log. The record that straddles begin ends within
+// VEML7700_LOG_RECORD_MAX bytes, so a parse is started at each of those
+// offsets. Parses that hit a malformed record are dropped, and parses that
+// land on the same offset agree from there on, so once a single parse
+// remains it is the log's own. Real data converges within a few records.
+// Returns end if the range holds no boundary that can be found this way.
+static size_t resync(const uint8_t *data, size_t length, size_t begin,
+                     size_t end) {
+  std::vector<Adafruit_VEML7700_LogReader> readers;
+  std::vector<size_t> at;
+  for (size_t c = begin; (c < begin + VEML7700_LOG_RECORD_MAX) && (c < end);
+       c++) {
+    readers.emplace_back(data + c, length - c);
+    at.push_back(c);
+  }
+
+  veml7700_log_record_t record;
+  while (!readers.empty()) {
+    size_t lowest = 0;
+    for (size_t i = 1; i < at.size(); i++) {
+      if (at[i] < at[lowest])
+        lowest = i;
+    }
+    if (at[lowest] >= end)
+      return end;
+    if (readers.size() == 1)
+      return at[0];
+
+    size_t from = at[lowest] - readers[lowest].offset();
+    bool alive = readers[lowest].next(&record);
+    at[lowest] = from + readers[lowest].offset();
+    // the end of the log is a boundary too
+    alive = alive || (at[lowest] == length);
+    for (size_t i = 0; alive && (i < at.size()); i++) {
+      if ((i != lowest) && (at[i] == at[lowest]))
+        alive = false;
+    }
+    if (!alive) {
+      readers.erase(readers.begin() + lowest);
+      at.erase(at.begin() + lowest);
+    }
+  }
+  return end;
+}
+
+// Decode a chunk, with times relative to its start if chunk.time is not
+// yet known, and write its readings to out if it is open
+static void convert(const uint8_t *data, Chunk *chunk, int out) {
+  size_t length = chunk->end - chunk->offset;
+  Adafruit_VEML7700_LogReader reader(data + chunk->offset, length,
+                                     chunk->time);
+  veml7700_log_record_t record;
+  Summary summary;
+  std::vector<OutputRecord> buffer;
+  if (out >= 0)
+    buffer.reserve(chunk->summary.count);
+
+  bool synced = false;
+  while (true) {
+    // next() applies time records itself, peek to note that one did
+    if ((reader.offset() < length) &&
+        (data[chunk->offset + reader.offset()] == VEML7700_LOG_TIME))
+      synced = true;
+    if (!reader.next(&record))
+      break;
+    float lux = veml7700_log_lux(&record);
+    summary.count++;
+    summary.sum += lux;
+    if (lux < summary.min)
+      summary.min = lux;
+    if (lux > summary.max)
+      summary.max = lux;
+    if (out >= 0)
+      buffer.push_back({record.timestamp, lux});
+  }
+
+  if (out >= 0) {
+    size_t bytes = buffer.size() * sizeof(OutputRecord);
+    off_t at = chunk->first * sizeof(OutputRecord);
+    if (pwrite(out, buffer.data(), bytes, at) != (ssize_t)bytes)
+      perror("write");
+    return;
+  }
+  chunk->summary = summary;
+  chunk->synced = synced;
+  chunk->endTime = reader.time();
+  chunk->stop = chunk->offset + reader.offset();
+}
+
+// Parse a -j value, a positive decimal count clamped to MAX_THREADS
+static bool parseThreads(const char *text, unsigned *threads) {
+  // strtoul would skip leading space and accept a minus sign
+  if (!isdigit((unsigned char)text[0]))
+    return false;
+  char *end;
+  errno = 0;
+  unsigned long value = strtoul(text, &end, 10);
+  if (*end || (errno == ERANGE) || (value < 1))
+    return false;
+  *threads = (value > MAX_THREADS) ? MAX_THREADS : value;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  unsigned threads = std::thread::hardware_concurrency();
+  const char *outName = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "j:o:")) != -1) {
+    switch (opt) {
+    case 'j':
+      if (!parseThreads(optarg, &threads)) {
+        fprintf(stderr, "usage: %s [-j THREADS] [-o OUTFILE] LOGFILE\n",
+                argv[0]);
+        return 2;
+      }
+      break;
+    case 'o':
+      outName = optarg;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-j THREADS] [-o OUTFILE] LOGFILE\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-j THREADS] [-o OUTFILE] LOGFILE\n", argv[0]);
+    return 2;
+  }
+  // hardware_concurrency() is 0 when unknown
+  if (threads < 1)
+    threads = 1;
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+
+  const char *name = argv[optind];
+  int fd = open(name, O_RDONLY);
+  struct stat st;
+  if ((fd < 0) || (fstat(fd, &st) < 0)) {
+    perror(name);
+    return 1;
+  }
+  size_t length = st.st_size;
+  const uint8_t *data = NULL;
+  if (length) {
+    void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      perror(name);
+      return 1;
+    }
+    madvise(map, length, MADV_SEQUENTIAL);
+    data = (const uint8_t *)map;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  // the first range starts at the file header, later ones resync
+  size_t ranges = length ? (length + CHUNK_BYTES - 1) / CHUNK_BYTES : 1;
+  std::vector<size_t> syncs(ranges);
+  parallel(threads, ranges, [&](size_t i) {
+    size_t begin = i * CHUNK_BYTES;
+    size_t end = std::min(begin + CHUNK_BYTES, length);
+    syncs[i] = i ? resync(data, length, begin, end) : 0;
+  });
+
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < ranges; i++) {
+    if (!i || (syncs[i] < std::min((i + 1) * CHUNK_BYTES, length))) {
+      if (!chunks.empty())
+        chunks.back().end = syncs[i];
+      chunks.push_back({syncs[i], length, length, 0, 0, 0, false, Summary()});
+    }
+  }
+  parallel(threads, chunks.size(),
+           [&](size_t i) { convert(data, &chunks[i], -1); });
+
+  // carry time and reading counts across the chunks, which stop at the
+  // first that could not be decoded to its end
+  int status = 0;
+  uint64_t total = 0;
+  uint32_t time = 0;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    Chunk &chunk = chunks[i];
+    chunk.first = total;
+    chunk.time = time;
+    total += chunk.summary.count;
+    time = chunk.synced ? chunk.endTime : time + chunk.endTime;
+    if (chunk.stop < chunk.end) {
+      fprintf(stderr, "%s: bad or truncated record at offset %lu\n", name,
+              (unsigned long)chunk.stop);
+      status = 1;
+      chunk.end = chunk.stop;
+      chunks.resize(i + 1);
+    }
+  }
+
+  if (outName) {
+    int out = open(outName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if ((out < 0) || (ftruncate(out, total * sizeof(OutputRecord)) < 0)) {
+      perror(outName);
+      return 1;
+    }
+    parallel(threads, chunks.size(),
+             [&](size_t i) { convert(data, &chunks[i], out); });
+    close(out);
+  }
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  Summary all;
+  for (auto &chunk : chunks) {
+    const Summary &s = chunk.summary;
+    all.count += s.count;
+    all.sum += s.sum;
+    if (s.min < all.min)
+      all.min = s.min;
+    if (s.max > all.max)
+      all.max = s.max;
+  }
+
+  printf("readings,%llu\n", (unsigned long long)all.count);
+  printf("threads,%u\n", threads);
+  printf("seconds,%.6f\n", seconds);
+  printf("readings_per_second,%.0f\n", seconds > 0 ? all.count / seconds : 0);
+  if (all.count) {
+    printf("min_lux,%.4f\n", all.min);
+    printf("mean_lux,%.4f\n", all.sum / all.count);
+    printf("max_lux,%.4f\n", all.max);
+  }
+
+  if (data)
+    munmap((void *)data, length);
+  close(fd);
+  return status;
+}
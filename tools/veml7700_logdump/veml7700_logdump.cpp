@@ -0,0 +1,63 @@
+/*!
+ *  @file veml7700_logdump.cpp
+ *
+ * 	Host tool that prints a VEML7700 binary log as CSV, converting the raw
+ * 	counts to lux with the library's own conversion math.
+ *
+ * 	Build from this directory with:
+ *
+ * 	  g++ -O2 -I../.. -o veml7700_logdump veml7700_logdump.cpp \
+ * 	      ../../Adafruit_VEML7700_Log.cpp ../../Adafruit_VEML7700_Lux.cpp
+ *
+ * 	Usage: veml7700_logdump LOGFILE
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Adafruit_VEML7700_Log.h"
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s LOGFILE\n", argv[0]);
+    return 2;
+  }
+
+  FILE *f = fopen(argv[1], "rb");
+  if (!f) {
+    perror(argv[1]);
+    return 1;
+  }
+  fseek(f, 0, SEEK_END);
+  long length = ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  uint8_t *data = (uint8_t *)malloc(length > 0 ? length : 1);
+  if (!data || (fread(data, 1, length, f) != (size_t)length)) {
+    perror(argv[1]);
+    fclose(f);
+    return 1;
+  }
+  fclose(f);
+
+  Adafruit_VEML7700_LogReader reader(data, length);
+  veml7700_log_record_t record;
+
+  printf("timestamp,als,white,gain,integration_time,corrected,lux\n");
+  while (reader.next(&record)) {
+    printf("%lu,%u,%u,%u,%u,%u,%.4f\n", (unsigned long)record.timestamp,
+           record.als, record.white, record.gain, record.integrationTime,
+           record.corrected, veml7700_log_lux(&record));
+  }
+
+  int status = 0;
+  if (reader.error() || (reader.offset() < (size_t)length)) {
+    fprintf(stderr, "%s: bad or truncated record at offset %lu\n", argv[1],
+            (unsigned long)reader.offset());
+    status = 1;
+  }
+  free(data);
+  return status;
+}
@@ -0,0 +1,179 @@
+/*!
+ *  @file veml7700_receive.cpp
+ *
+ * 	Host tool that receives readings streamed in COBS framed packets, see
+ * 	Adafruit_VEML7700_Stream.h, from a serial device or pty and prints
+ * 	them as CSV.
+ *
+ * 	Build from this directory with:
+ *
+ * 	  g++ -O2 -I../.. -o veml7700_receive veml7700_receive.cpp \
+ * 	      ../../Adafruit_VEML7700_Stream.cpp \
+ * 	      ../../Adafruit_VEML7700_Log.cpp ../../Adafruit_VEML7700_Lux.cpp
+ *
+ * 	Usage: veml7700_receive [-b BAUD] [-n COUNT] DEVICE
+ *
+ * 	DEVICE is a serial port such as /dev/ttyACM0, a pty, a file or - for
+ * 	standard input. Terminals are put in raw mode at BAUD, 115200 by
+ * 	default. Receiving stops after COUNT readings, at end of file or on
+ * 	Ctrl-C, then packet, error and loss counts go to standard error.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Adafruit_VEML7700_Stream.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void interrupted(int) { stop = 1; }
+
+static speed_t baudRate(long baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 115200:
+    return B115200;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  case 921600:
+    return B921600;
+  case 1000000:
+    return B1000000;
+  case 2000000:
+    return B2000000;
+  default:
+    return 0;
+  }
+}
+
+int main(int argc, char **argv) {
+  long baud = 115200;
+  unsigned long limit = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:n:")) != -1) {
+    switch (opt) {
+    case 'b':
+      baud = atol(optarg);
+      break;
+    case 'n':
+      limit = strtoul(optarg, NULL, 10);
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-b BAUD] [-n COUNT] DEVICE\n", argv[0]);
+      return 2;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-b BAUD] [-n COUNT] DEVICE\n", argv[0]);
+    return 2;
+  }
+
+  const char *name = argv[optind];
+  int fd = strcmp(name, "-") ? open(name, O_RDONLY | O_NOCTTY) : 0;
+  if (fd < 0) {
+    perror(name);
+    return 1;
+  }
+
+  if (isatty(fd)) {
+    struct termios tty;
+    speed_t speed = baudRate(baud);
+    if (!speed) {
+      fprintf(stderr, "%s: unsupported baud rate %ld\n", argv[0], baud);
+      return 2;
+    }
+    if (tcgetattr(fd, &tty) < 0) {
+      perror(name);
+      return 1;
+    }
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tty) < 0) {
+      perror(name);
+      return 1;
+    }
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = interrupted;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  Adafruit_VEML7700_StreamDecoder decoder;
+  unsigned long readings = 0, lost = 0, other = 0;
+  uint16_t expected = 0;
+  bool first = true;
+  uint8_t buffer[4096];
+
+  printf("sequence,timestamp,als,white,gain,it,corrected,lux\n");
+  while (!stop && (!limit || (readings < limit))) {
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      // a pty reports EIO once the other side closes
+      if (errno != EIO)
+        perror(name);
+      break;
+    }
+    if (n == 0)
+      break;
+
+    for (ssize_t i = 0; (i < n) && (!limit || (readings < limit)); i++) {
+      size_t length = decoder.push(buffer[i]);
+      if (!length)
+        continue;
+
+      uint16_t sequence;
+      veml7700_log_record_t record;
+      if (!veml7700_stream_parse_reading(decoder.payload(), length, &sequence,
+                                         &record)) {
+        other++;
+        continue;
+      }
+      if (!first)
+        lost += (uint16_t)(sequence - expected);
+      first = false;
+      expected = sequence + 1;
+      readings++;
+
+      printf("%u,%lu,%u,%u,%u,%u,%u,%.4f\n", sequence,
+             (unsigned long)record.timestamp, record.als, record.white,
+             record.gain, record.integrationTime, record.corrected,
+             veml7700_log_lux(&record));
+    }
+    fflush(stdout);
+  }
+
+  fprintf(stderr,
+          "readings %lu, lost %lu, crc errors %lu, framing errors %lu, "
+          "other packets %lu\n",
+          readings, lost, (unsigned long)decoder.crcErrors(),
+          (unsigned long)decoder.framingErrors(), other);
+  if (fd)
+    close(fd);
+  return 0;
+}